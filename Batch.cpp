@@ -0,0 +1,117 @@
+#include "Batch.h"
+#include "NES.h"
+#include "RandomInput.h"
+#include "ThreadPool.h"
+#include <chrono>
+
+// Wall clock seconds since some fixed point
+static double now() {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Batch::Batch(long frames, bool recompile, int frame_skip,
+    const MovieInput* movie) :
+    frames(frames),
+    recompile(recompile),
+    frame_skip(frame_skip),
+    movie(movie) {
+}
+
+void Batch::add_job(const char* rom_file, unsigned int seed) {
+    Job job;
+    job.rom_file = rom_file;
+    job.seed = seed;
+    job.frames_run = 0;
+    job.instructions = 0;
+    job.seconds = 0;
+    job.hash = 0;
+    
+    jobs.push_back(job);
+}
+
+void Batch::run_job(Job &job) {
+    RandomInput random_input(job.seed);
+    MovieInput movie_input;
+    
+    InputSource* input = 0;
+    
+    if(job.seed) input = &random_input;
+    else if(movie) {
+        movie_input = *movie;
+        movie_input.rewind();
+        input = &movie_input;
+    }
+    
+    try {
+        // Too big for a thread's stack
+        NES* nes = new NES(job.rom_file.c_str(), 0, input, recompile);
+        
+        double start = now();
+        
+        // The last frame is always drawn, for its hash
+        nes->set_frame_skip(frame_skip);
+        if(nes->run(frames - 1)) {
+            nes->set_frame_skip(0);
+            nes->run(1);
+        }
+        
+        job.seconds = now() - start;
+        
+        job.frames_run = nes->get_frame_count();
+        job.instructions = nes->get_instruction_count();
+        job.hash = nes->get_frame_hash();
+        
+        delete nes;
+    }
+    catch(const char* ex) {
+        job.error = ex;
+    }
+}
+
+void Batch::run(int threads) {
+    double start = now();
+    long total_frames = 0;
+    long long total_instructions = 0;
+    
+    {
+        ThreadPool pool(threads);
+        threads = pool.size();
+        
+        for(unsigned int i = 0; i < jobs.size(); i++)
+            pool.submit(std::bind(&Batch::run_job, this, std::ref(jobs[i])));
+        
+        pool.wait();
+    }
+    
+    double seconds = now() - start;
+    
+    for(unsigned int i = 0; i < jobs.size(); i++) {
+        const Job &job = jobs[i];
+        
+        printf("%s", job.rom_file.c_str());
+        if(job.seed) printf(" seed %u", job.seed);
+        
+        if(!job.error.empty()) {
+            printf(": %s\n", job.error.c_str());
+            continue;
+        }
+        
+        printf(": frames %ld, %.3fs, %.1f fps, %.1fM instructions/s, "
+            "hash %016llx%s\n",
+            job.frames_run, job.seconds,
+            job.seconds > 0 ? job.frames_run / job.seconds : 0.0,
+            job.seconds > 0 ? job.instructions / job.seconds / 1e6 : 0.0,
+            job.hash, job.frames_run < frames ? " (halted)" : "");
+        
+        total_frames += job.frames_run;
+        total_instructions += job.instructions;
+    }
+    
+    if(jobs.size() > 1)
+        printf("%u jobs, %d threads: frames %ld, %.3fs, %.1f fps, "
+            "%.1fM instructions/s\n",
+            (unsigned int) jobs.size(), threads, total_frames, seconds,
+            seconds > 0 ? total_frames / seconds : 0.0,
+            seconds > 0 ? total_instructions / seconds / 1e6 : 0.0);
+}
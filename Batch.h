@@ -0,0 +1,49 @@
+// Runs many headless emulators at once: one job per ROM and input, spread
+// over a thread pool. Each job reports the hash of its last frame and how
+// fast it ran, so runs can be compared against known good results.
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "Constants.h"
+#include "MovieInput.h"
+#include <string>
+#include <vector>
+
+class Batch {
+    struct Job {
+        std::string rom_file;
+        
+        // Seed for random input, 0 for none
+        unsigned int seed;
+        
+        // Results
+        long frames_run;
+        long long instructions;
+        double seconds;
+        unsigned long long hash;
+        std::string error;
+    };
+    
+    std::vector<Job> jobs;
+    
+    long frames;
+    bool recompile;
+    int frame_skip;
+    
+    // Played back by every job without a seed, may be null
+    const MovieInput* movie;
+    
+    void run_job(Job &job);
+    
+public:
+    Batch(long frames, bool recompile, int frame_skip, const MovieInput* movie);
+    
+    void add_job(const char* rom_file, unsigned int seed);
+    
+    // Run all the jobs on a number of threads, 0 for one per core, and
+    // print the results in the order the jobs were added
+    void run(int threads);
+};
+
+#endif // BATCH_H
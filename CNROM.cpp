@@ -0,0 +1,9 @@
+#include "CNROM.h"
+
+CNROM::CNROM(const ROM &rom, Memory &mem, PPU &ppu, Controller &controller_1)
+    : Mapper(rom, mem, ppu, controller_1) {
+}
+
+void CNROM::write_register(Byte data, Word address) {
+    map_CHR_8K(data);
+}
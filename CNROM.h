@@ -0,0 +1,19 @@
+// CNROM (mapper 3)
+//
+// Any write to $8000-$FFFF selects the 8KB CHR-ROM bank. PRG-ROM is 16KB
+// or 32KB and isn't switched.
+
+#ifndef CNROM_H
+#define CNROM_H
+
+#include "Constants.h"
+#include "Mapper.h"
+
+class CNROM : public Mapper {
+    void write_register(Byte data, Word address);
+    
+public:
+    CNROM(const ROM &rom, Memory &mem, PPU &ppu, Controller &controller_1);
+};
+
+#endif // CNROM_H
@@ -1,11 +1,53 @@
 #include "CPU.h"
 
-CPU::CPU(Mapper &_mem) : mem(_mem) {
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <sys/mman.h>
+#endif
+
+CPU::CPU(Mapper &_mem) : 
+    mem(_mem),
+    interrupts(0),
+    halted(false),
+    cycles_run(0),
+    cycles_left(0),
+    cycles_held(0),
+    instructions_run(0),
+    block_cycles(0),
+    idle_head(0),
+    idle_tail(0),
+    idle_loop(false),
+    idle_checked(false),
+    idle_passes(0),
+    blocks(0),
+    code_cache(0),
+    code_cache_used(0) {
+    
     // Load opcode_data table
     load_opcode_data();
+    
+    // Build handler table from it
+    load_opcodes();
+    
+    decode_cache = new Decoded[0x8000];
+    memset(decode_cache, 0, sizeof(Decoded) * 0x8000);
+    
+    for(int bank = 0; bank < 4; bank++) {
+        decoded_banks[bank] = 0;
+        bank_generation[bank] = 0;
+    }
+}
+
+CPU::~CPU() {
+    delete[] decode_cache;
+#if defined(__x86_64__) && defined(__GNUC__)
+    if(code_cache) munmap(code_cache, CODE_CACHE_SIZE);
+#endif
+    if(blocks) delete[] blocks;
 }
 
 void CPU::reset() {
+    halted = false;
+    
     // Reset registers
     A = X = Y = 0x00;
     S = 0xFF; // Stack grows downward from 0xFF. Add 0x100
@@ -14,66 +56,60 @@ void CPU::reset() {
     N = V = B = D = I = Z = C = 0;
     U = 1;
     
+    interrupts = 0;
+    instructions_run = 0;
+    
+    // Pick up the PRG banks now mapped in
+    sync_PRG_banks();
+    
     // Set to address contained in RESET handler routine
     PC = mem.read_word(RESET_VECTOR);
 }
 
+// NMI wins if both are pending. An IRQ waits while the I flag is set.
 inline void CPU::handle_interrupt() {
-    switch(interrupt) {
-        case NMI: {
-            //puts("NMI happening");
-
-            stack_push_word(PC);
-            stack_push(pack_flags());
-            PC = mem.read_word(NMI_VECTOR);
-            cycle_count += 7;
-            break;
-        }
-        case RESET: {
-            //puts("RESET happening");
-            
-            reset();
-            cycle_count += 7;
-            break;
-        }
-        case IRQ: {
-            if(I != 0) {
-                // Interrupts disabled (I flag set)
-                break;
-            }
-            //puts("IRQ happening");
-            
-            stack_push_word(PC);
-            stack_push(pack_flags());
-            I = 1;
-            B = 0;
-            PC = mem.read_word(IRQ_VECTOR);
-            cycle_count += 7;
-            break;
-        }
+    if(!interrupts) return;
+    
+    if(interrupts & NMI_LINE) {
+        interrupts &= ~NMI_LINE;
+        
+        stack_push_word(PC);
+        stack_push(pack_flags());
+        PC = mem.read_word(NMI_VECTOR);
+        cycle_count += 7;
+    }
+    else if(!I) {
+        stack_push_word(PC);
+        stack_push(pack_flags());
+        I = 1;
+        B = 0;
+        PC = mem.read_word(IRQ_VECTOR);
+        cycle_count += 7;
     }
-    interrupt = -1;
 }
 
-inline Word CPU::get_operand_address(Byte opcode) {
+// Effective address for an addressing mode. Resolved at compile time, so
+// each opcode handler only contains the code for its own mode.
+template<int MODE>
+inline Word CPU::address(Word operand) {
     Word address = 0;
     
-    // Determine addressing mode from opcode
-    switch(opcode_data[opcode][ADDRESS_MODE]) {
+    switch(MODE) {
         
         // operand is an 8 bit constant which follows the instruction
+        // (read straight from the operand by load())
         case IMMEDIATE:
-            address = PC;
+            address = PC - 1;
             break;
  
         // 16 bit address pointing to operand   
         case ABSOLUTE:
-            address = mem.read_word(PC);
+            address = operand;
             break;
             
         // Uses absolute (16 bit) address and adds X register   
         case ABSOLUTE_X:
-            address = mem.read_word(PC);
+            address = operand;
             if((address & 0xFF00) != ((address + X) & 0xFF00))
                 cycle_count++;
             address += X;
@@ -81,7 +117,7 @@ inline Word CPU::get_operand_address(Byte opcode) {
         
         // Same as above, except Y register used
         case ABSOLUTE_Y:
-            address = mem.read_word(PC);
+            address = operand;
             if((address & 0xFF00) != ((address + Y) & 0xFF00))
                 cycle_count++;
             address += Y;
@@ -89,27 +125,27 @@ inline Word CPU::get_operand_address(Byte opcode) {
             
         // 8 bit operand, from 0x00 to 0xFF in memory (zero page)   
         case ZERO_PAGE:
-            address = mem.read(PC);
+            address = operand & 0xFF;
             break;
             
         // 8 bit address with X added. Wraps around
         case ZERO_PAGE_X:
-            address = (mem.read(PC) + X) & 0xFF;
+            address = (operand + X) & 0xFF;
             break;
             
         // 8 bit address with Y added. Wraps around
         case ZERO_PAGE_Y:
-            address = (mem.read(PC) + X) & 0xFF;
+            address = (operand + Y) & 0xFF;
             break;
             
         //  Only supported by JMP
         case INDIRECT:
-            address = mem.read_word(mem.read_word(PC));
+            address = mem.read_word(operand);
             break;
             
         // like indirect, but add X
         case INDIRECT_X:
-            address = mem.read(PC);
+            address = operand & 0xFF;
             if((address & 0xFF00) != ((address + X) & 0xFF00))
                 cycle_count++;
             address = mem.read_word((address + X) & 0xFF);
@@ -117,15 +153,16 @@ inline Word CPU::get_operand_address(Byte opcode) {
             
         //  
         case INDIRECT_Y:
-            address = mem.read_word(mem.read(PC));
+            address = mem.read_word(operand & 0xFF);
             if((address & 0xFF00) != ((address + Y) & 0xFF00))
                 cycle_count++;
             address += Y;
             break;
             
-        // Sets address to PC + relative displacement (if branch taken)
+        // Sets address to PC + relative displacement (if branch taken).
+        // PC already points at the following instruction.
         case RELATIVE:
-            address = (((signed char) mem.read(PC)) + PC + 1);
+            address = ((signed char) operand) + PC;
             break;
             
         // Operate directly on Accumulator. Nice and easy, like Implied mode.   
@@ -141,734 +178,1196 @@ inline Word CPU::get_operand_address(Byte opcode) {
     return address & 0xFFFF;
 }
 
+// Value an instruction operates on
+template<int MODE>
+inline Byte CPU::load(Word operand) {
+    if(MODE == IMMEDIATE) return operand & 0xFF;
+    return mem.read(address<MODE>(operand));
+}
+
+// Writes to PRG-ROM go to the mapper, and may switch banks
+inline void CPU::write(Byte data, Word address) {
+    mem.write(data, address);
+    if(address >= 0x8000) sync_PRG_banks();
+}
+
+// Execute the instruction at PC, returning the cycles it took
+inline int CPU::step() {
+    // PRG-ROM doesn't change under us, so use the decode cache
+    if(PC >= 0x8000) {
+        Decoded &decoded = decode_cache[PC - 0x8000];
+        
+        if(decoded.generation != bank_generation[(PC >> 13) & 3])
+            decode(decoded, PC);
+        
+        PC += decoded.length;
+        (this->*decoded.execute)(decoded.operand);
+        
+        return decoded.time + cycle_count;
+    }
+    
+    // Look up the handler for the opcode at PC
+    const Opcode &op = opcodes[mem.read(PC)];
+    
+    // Fetch the operand bytes following the opcode
+    Word operand = 0;
+    if(op.length == 2) operand = mem.read(PC + 1);
+    else if(op.length == 3) operand = mem.read_word(PC + 1);
+    
+    // Move PC on to the next instruction, then execute
+    PC += op.length;
+    (this->*op.execute)(operand);
+    
+    // The number of cycles used by the instruction + the extra cycles
+    return op.time + cycle_count;
+}
+
+// Fill in a decode cache entry for the instruction at address
+void CPU::decode(Decoded &decoded, Word address) {
+    const Opcode &op = opcodes[mem.read(address)];
+    
+    decoded.execute = op.execute;
+    decoded.length = op.length;
+    decoded.time = op.time;
+    
+    decoded.operand = 0;
+    if(op.length == 2) decoded.operand = mem.read(address + 1);
+    else if(op.length == 3) decoded.operand = mem.read_word(address + 1);
+    
+    // Instructions straddling two banks are decoded every time, as
+    // either bank could be switched
+    int last = (address + op.length - 1) & 0xFFFF;
+    if(last >= 0x8000 && (last >> 13) == (address >> 13))
+        decoded.generation = bank_generation[(address >> 13) & 3];
+    else
+        decoded.generation = 0;
+}
+
+// Check the PRG banks mapped at $8000-$FFFF against the ones the caches
+// were filled from. A switched bank gets a new generation, which retires
+// all of its decoded instructions and compiled blocks at once.
+void CPU::sync_PRG_banks() {
+    for(int bank = 0; bank < 4; bank++) {
+        const Byte* current = mem.get_PRG_bank(bank);
+        
+        if(current == decoded_banks[bank]) continue;
+        
+        decoded_banks[bank] = current;
+        
+        // On wrap around, old entries could look valid again
+        if(++bank_generation[bank] == 0) {
+            bank_generation[bank] = 1;
+            memset(&decode_cache[bank * 0x2000], 0, sizeof(Decoded) * 0x2000);
+            if(blocks) memset(&blocks[bank * 0x2000], 0, sizeof(Block) * 0x2000);
+        }
+    }
+}
+
 long CPU::emulate(long cycles) {
-    // Stores current opcode for decoding instruction
-    Byte opcode;
+    cycles_run = cycles;
+    cycles_left = cycles;
+    cycles_held = 0;
+    
+    if(halted) return 0;
     
-    // Address of current operand
-    Word address;
+    // Loop passes can only be compared within one budget
+    idle_checked = false;
+    idle_passes = 0;
     
-    while(cycles > 0) {
+    if(blocks) return emulate_recompiled();
+    
+    // Interrupts are dispatched before the first instruction, and after
+    // anything that stops the run to let one in. The loop itself has no
+    // check.
+    do {
         // Reset extra cycles counter
         cycle_count = 0;
         
-        // Dispatch interrupts
         handle_interrupt();
         
-        // Read opcode from memory and increment program counter
-        opcode = mem.read(PC++);
-        
-        // Get the operand address, and set page_crossed if page boundary crossed
-        address = get_operand_address(opcode);
-        
-        // Increment PC by length of instruction's operand
-        // (minus one due to previous increment)
-        PC += (opcode_data[opcode][OP_LENGTH] - 1) & 0xFFFF;
+        do {
+            cycles_left -= step();
+            cycle_count = 0;
+            instructions_run++;
+            
+            //print_regs();
+        } while(cycles_left > 0);
+    } while(resume_after_interrupt());
+    
+    return cycles_left;
+}
+
+void CPU::end_run_in(long cycles) {
+    long cut = cycles_run + cycles_held - (get_elapsed_cycles() + cycles);
+    if(cut <= 0) return;
+    
+    // Out of the budget set aside for after an interrupt first
+    long held = cut < cycles_held ? cut : cycles_held;
+    cycles_held -= held;
+    cut -= held;
+    
+    cycles_run -= cut;
+    cycles_left -= cut;
+}
+
+// An interrupt that can be taken has come up during the run: from the
+// hardware, or by the I flag being cleared while an IRQ is held. End the
+// run after the current instruction, setting the rest of the budget
+// aside. Does nothing between runs, or when no interrupt is ready.
+void CPU::stop_for_interrupt() {
+    if(!interrupt_ready()) return;
+    
+    long cut = cycles_run - get_elapsed_cycles();
+    if(cut <= 0) return;
+    
+    cycles_run -= cut;
+    cycles_left -= cut;
+    cycles_held += cut;
+}
+
+// Take back the budget set aside by stop_for_interrupt(). Returns whether
+// the run should go on, taking the interrupt first. If the budget ran out
+// anyway, it waits for the next run.
+bool CPU::resume_after_interrupt() {
+    if(!cycles_held) return false;
+    
+    cycles_run += cycles_held;
+    cycles_left += cycles_held;
+    cycles_held = 0;
+    
+    return cycles_left > 0 && !halted;
+}
+
+// Idle loops
+//
+// Games spend much of each frame spinning until the NMI or the PPU comes
+// round: "JMP *", "LDA $2002 / BPL", "LDA flag / BEQ". Such a loop only
+// reads, so once passes through it stop changing the registers, every
+// later pass is the same until something outside the CPU changes - which
+// only happens between calls to emulate(). The passes that fit in the
+// rest of the budget are then skipped in one go. The last one is left to
+// run, so the budget ends on the same instruction as when interpreted.
+
+// Does the code from head up to the branch or jump at tail only read,
+// and only from places where reading has no side effects?
+bool CPU::is_idle_loop(Word head, Word tail) {
+    // Fetching code from the registers would have side effects itself
+    if((head >= 0x2000 && head < 0x6000) || (tail >= 0x2000 && tail < 0x6000))
+        return false;
+    
+    Word address = head;
+    
+    while(address < tail) {
+        Byte opcode = mem.read(address);
+        Byte instruction = opcode_data[opcode][INSTRUCTION];
+        Byte mode = opcode_data[opcode][ADDRESS_MODE];
         
-        //printf("Address: %x\n", address);
+        switch(instruction) {
+            // Writes to memory or the stack
+            case STA: case STX: case STY: case INC: case DEC:
+            case PHA: case PHP: case JSR: case BRK:
+            // Return somewhere else, or let an interrupt in
+            case PLA: case PLP: case RTS: case RTI: case CLI:
+            // Invalid
+            case 0xFF:
+            // Only the jump at tail may leave the code checked here
+            case JMP:
+                return false;
+        }
         
-        // Execute instructions
+        Word operand = mem.read_word(address + 1);
         
-        switch(opcode_data[opcode][INSTRUCTION]) {
-            
-            // ADC - Add with Carry
-            // Flags: C, Z, V, N
-            
-            case ADC: {
-                //puts("ADC");
-                short temp1 = A + mem.read(address) + C;
-                C = temp1 > 0xFF ? 1 : 0;
-                Z = temp1 & 0xFF;
-                V = ((!(((A ^ mem.read(address)) & 0x80) != 0)
-                    && (((A ^ temp1) & 0x80)) != 0) ? 1 : 0);
-                N = (temp1 >> 7) & 1;
-                A = temp1 & 0xFF;
-                break;
-            }
-                
-            // AND - Logical AND
-            // Flags: Z, N
-            
-            case AND: {
-                //puts("AND");
-                short temp1 = A & mem.read(address);
-                Z = temp1;
-                N = (temp1 >> 7) & 1;
-                A = temp1 & 0xFF;
+        switch(mode) {
+            case IMPLIED:
+            case ACCUMULATOR:
+            case IMMEDIATE:
+            case ZERO_PAGE:
                 break;
-            }   
                 
-            // ASL - Arithmetic Shift Left
-            // Flags: C, Z, N
-            
-            case ASL: {
-                //puts("ASL");
-                if(opcode_data[opcode][ADDRESS_MODE] == ACCUMULATOR) {
-                    C = (A >> 7) & 1;
-                    A = (A << 1) & 0xFF;
-                    Z = A;
-                    N = (A >> 7) & 1;
-                }
-                else {
-                    short temp1 = mem.read(address);
-                    C = (temp1 >> 7) & 1;
-                    temp1 = (temp1 << 1) & 0xFF;
-                    Z = temp1;
-                    N = (temp1 >> 7) & 1;
-                    mem.write((temp1 & 0xFF), address);
-                }
+            // A branch out of the loop could run anything
+            case RELATIVE: {
+                int target = address + 2 + (signed char) (operand & 0xFF);
+                if(target < head || target > tail) return false;
                 break;
             }
                 
-            // BIT - Bit Test
-            // Flags: Z, V, N
-            
-            case BIT: {
-                //puts("BIT");
-                short temp1 = mem.read(address);
-                Z = temp1 & A;
-                V = (temp1 >> 6) & 1;
-                N = (temp1 >> 7) & 1;
-                break;
-            }
-            
-            // BPL - Branch if Positive
-            // Flags: none
-            
-            case BPL: {
-                //puts("BPL");
-                if(N == 0) {
-                    cycle_count += 
-                    (((PC - opcode_data[opcode][OP_LENGTH]) & 0xFF00) 
-                    != (address & 0xFF00));
-                    cycle_count++;
-                    PC = address;
-                }
-                break;
-            }
-                        
-            // BMI - Branch if Minus
-            // Flags: none
-            
-            case BMI: {
-                //puts("BMI");
-                if(N != 0) {
-                    cycle_count += 
-                    (((PC - opcode_data[opcode][OP_LENGTH]) & 0xFF00) 
-                    != (address & 0xFF00));
-                    cycle_count++;
-                    PC = address;
-                }
-                break;
-            }
-                        
-            // BVC - Branch if Overflow Clear
-            // Flags: none
-            
-            case BVC: {
-                //puts("BVC");
-                if(V == 0) {
-                    cycle_count += 
-                    (((PC - opcode_data[opcode][OP_LENGTH]) & 0xFF00) 
-                    != (address & 0xFF00));
-                    cycle_count++;
-                    PC = address;
-                }
+            // Reading $2007 moves the VRAM address, $4016/7 shift the
+            // controllers
+            case ABSOLUTE:
+                if((operand >= 0x2000 && operand < 0x4000 && (operand & 7) == 7)
+                    || operand == 0x4016 || operand == 0x4017)
+                    return false;
                 break;
-            }
                 
-            // BVS - Branch if Overflow Set
-            // Flags: none
-            
-            case BVS: {
-                //puts("BVS");
-                if(V != 0) {
-                    cycle_count += 
-                    (((PC - opcode_data[opcode][OP_LENGTH]) & 0xFF00) 
-                    != (address & 0xFF00));
-                    cycle_count++;
-                    PC = address;
-                }
-                break;
-            }
-                
-            // BCC - Branch if Carry Clear
-            // Flags: none
-            
-            case BCC: {
-                //puts("BCC");
-                if(C == 0) {
-                    cycle_count += 
-                    (((PC - opcode_data[opcode][OP_LENGTH]) & 0xFF00) 
-                    != (address & 0xFF00));
-                    cycle_count++;
-                    PC = address;
-                }
-                break;
-            }
-                
-            // BCS - Branch if Carry Set
-            // Flags: none
-            
-            case BCS: {
-                //puts("BCS");
-                if(C != 0) {
-                    cycle_count += 
-                    (((PC - opcode_data[opcode][OP_LENGTH]) & 0xFF00) 
-                    != (address & 0xFF00));
-                    cycle_count++;
-                    PC = address;
-                }
-                break;
-            }   
-                
-            // BNE - Branch if Not Equal
-            // Flags: none
-            
-            case BNE: {
-                //puts("BNE");
-                if(Z != 0) {
-                    cycle_count += 
-                    (((PC - opcode_data[opcode][OP_LENGTH]) & 0xFF00) 
-                    != (address & 0xFF00));
-                    cycle_count++;
-                    PC = address;
-                }
-                break;
-            }
-                
-            // BEQ - Branch if Equal
-            // Flags: none
-            
-            case BEQ: {
-                //puts("BEQ");
-                if(Z == 0) {
-                    cycle_count += 
-                    (((PC - opcode_data[opcode][OP_LENGTH]) & 0xFF00) 
-                    != (address & 0xFF00));
-                    cycle_count++;
-                    PC = address;
-                }
-                break;
-            }   
-                
-            // BRK - Force Interrupt
-            // Flags: B
-            
-            case BRK: {
-                //puts("BRK");
-                stack_push_word(PC + 1);
-                B = 1; // Flags pushed with B set
-                stack_push(pack_flags());
-                I = 1;
-                PC = mem.read_word(IRQ_VECTOR);
-                break;
-            }
-                
-            // CMP - Compare
-            // Flags: Z, C, N
-            
-            case CMP: {
-                //puts("CMP");
-                short temp1 = A - mem.read(address);
-                C = temp1 >= 0 ? 1 : 0;
-                Z = temp1 & 0xFF;
-                N = (temp1 >> 7) & 1;
-                break;
-            }   
-                
-            // CPX - Compare X Register
-            // Flags: Z, C, N
-            
-            case CPX: {
-                //puts("CPX");
-                short temp1 = X - mem.read(address);
-                C = temp1 >= 0 ? 1 : 0;
-                Z = temp1 & 0xFF;
-                N = (temp1 >> 7) & 1;
-                break;
-            }
-                
-            // CPY - Compare Y Register
-            // Flags: Z, C, N
-            
-            case CPY: {
-                //puts("CPY");
-                short temp1 = Y - mem.read(address);
-                C = temp1 >= 0 ? 1 : 0;
-                Z = temp1 & 0xFF;
-                N = (temp1 >> 7) & 1;
-                break;
-            }           
+            // Anything indexed or indirect could land anywhere
+            default:
+                return false;
+        }
+        
+        address += opcode_data[opcode][OP_LENGTH];
+    }
+    
+    return address == tail;
+}
 
-            // DEC - Decrement Memory
-            // Flags: Z, N
-            
-            case DEC: {
-                //puts("DEC");
-                short temp1 = (mem.read(address) - 1) & 0xFF;
-                Z = temp1;
-                N = (temp1 >> 7) & 1;
-                mem.write((temp1 & 0xFF), address);
-                break;
-            }       
+// Called when a branch or jump of the given base time at tail is about to
+// go back to head
+void CPU::check_idle_loop(Word head, Word tail, int time) {
+    if(!idle_checked || head != idle_head || tail != idle_tail) {
+        idle_head = head;
+        idle_tail = tail;
+        idle_loop = is_idle_loop(head, tail);
+        idle_checked = true;
+        idle_passes = 0;
+    }
+    
+    if(!idle_loop) return;
+    
+    // Budget left at the start of this instruction
+    long position = cycles_left - block_cycles - cycle_count;
+    
+    unsigned int regs = A | X << 8 | Y << 16 | S << 24;
+    Byte flags = pack_flags();
+    long period = idle_position - position;
+    
+    // A pass only counts if it took as long as the one before, so a
+    // pass that started with an interrupt is never used as the length
+    if(idle_passes > 0 && regs == idle_regs && flags == idle_flags
+        && period > 0 && (idle_passes == 1 || period == idle_period))
+        idle_passes++;
+    else
+        idle_passes = 1;
+    
+    idle_regs = regs;
+    idle_flags = flags;
+    idle_position = position;
+    idle_period = period;
+    
+    if(idle_passes < 3) return;
+    
+    // Skip the whole passes left, bar the last
+    long left = position - time;
+    if(left > idle_period) {
+        long passes = (left - 1) / idle_period;
+        cycle_count += passes * idle_period;
+        idle_position -= passes * idle_period;
+    }
+}
 
-            // EOR - Exclusive OR
-            // Flags: Z, N
-            
-            case EOR: {
-                //puts("EOR");
-                A ^= mem.read(address) & 0xFF;
-                Z = A;
-                N = (A >> 7) & 1;
-                break;
-            }
+// ADC - Add with Carry
+// Flags: C, Z, V, N
 
-            // CLC - Clear Carry Flag
-            // Flags: C
-            
-            case CLC: {
-                //puts("CLC");
-                C = 0;
-                break;
-            }
+template<int MODE>
+void CPU::op_ADC(Word operand) {
+    Byte value = load<MODE>(operand);
+    short temp1 = A + value + C;
+    C = temp1 > 0xFF ? 1 : 0;
+    Z = temp1 & 0xFF;
+    V = ((!(((A ^ value) & 0x80) != 0)
+        && (((A ^ temp1) & 0x80)) != 0) ? 1 : 0);
+    N = (temp1 >> 7) & 1;
+    A = temp1 & 0xFF;
+}
 
-            // SEC - Set Carry Flag
-            // Flags: C
+// AND - Logical AND
+// Flags: Z, N
 
-            case SEC: {
-                //puts("SEC");
-                C = 1;
-                break;
-            }
-            
-            // CLI - Clear Interrupt Disable
-            // Flags: I
-            
-            case CLI: {
-                //puts("CLI");
-                I = 0;
-                break;
-            }       
+template<int MODE>
+void CPU::op_AND(Word operand) {
+    short temp1 = A & load<MODE>(operand);
+    Z = temp1;
+    N = (temp1 >> 7) & 1;
+    A = temp1 & 0xFF;
+}
 
-            // SEI - Set Interrupt Disable
-            // Flags: I
-            
-            case SEI: {
-                //puts("SEI");
-                I = 1;
-                break;
-            }           
+// ASL - Arithmetic Shift Left
+// Flags: C, Z, N
 
-            // CLV - Clear Overflow Flag
-            // Flags: V
-            
-            case CLV: {
-                //puts("CLV");
-                V = 0;
-                break;
-            }
-                
-            // CLD - Clear Decimal Mode
-            // Flags: D
-            
-            case CLD: {
-                //puts("CLD");
-                D = 0;
-                break;
-            }               
+template<int MODE>
+void CPU::op_ASL(Word operand) {
+    if(MODE == ACCUMULATOR) {
+        C = (A >> 7) & 1;
+        A = (A << 1) & 0xFF;
+        Z = A;
+        N = (A >> 7) & 1;
+    }
+    else {
+        Word address = CPU::address<MODE>(operand);
+        short temp1 = mem.read(address);
+        C = (temp1 >> 7) & 1;
+        temp1 = (temp1 << 1) & 0xFF;
+        Z = temp1;
+        N = (temp1 >> 7) & 1;
+        write((temp1 & 0xFF), address);
+    }
+}
 
-            // SED - Set Decimal Flag
-            // Flags: D
-            
-            case SED: {
-                //puts("SED");
-                D = 1;
-                break;
-            }
-                
-            // INC - Increment Memory
-            // Flags: Z, N
-            
-            case INC: {
-                //puts("INC");
-                short temp1 = (mem.read(address) + 1) &0xFF;
-                Z = temp1;
-                N = (temp1 >> 7) & 1;
-                mem.write((temp1 & 0xFF), address);
-                break;
-            }           
+// BIT - Bit Test
+// Flags: Z, V, N
 
-            // JMP - Jump - check this
-            // Flags: none
-            
-            case JMP: {
-                //puts("JMP");
-                PC = address;
-                break;
-            }
-                
-            // JSR - Jump to Subroutine - check this
-            // Flags: none
-            
-            case JSR: {
-                //puts("JSR");
-                stack_push_word(PC - 1);
-                PC = address;
-                break;
-            }               
+template<int MODE>
+void CPU::op_BIT(Word operand) {
+    short temp1 = load<MODE>(operand);
+    Z = temp1 & A;
+    V = (temp1 >> 6) & 1;
+    N = (temp1 >> 7) & 1;
+}
 
-            // LDA - Load Accumulator
-            // Flags: Z, N
-            
-            case LDA: {
-                //puts("LDA");
-                A = mem.read(address);
-                Z = A;
-                N = (A >> 7) & 1; 
-                break;
-            }           
+// Branches take an extra cycle, plus one more if the target is on a
+// different page to the branch instruction
+inline void CPU::branch(Word operand) {
+    Word address = CPU::address<RELATIVE>(operand);
+    cycle_count += (((PC - 2) & 0xFF00) != (address & 0xFF00));
+    cycle_count++;
+    
+    if(address < PC && PC - address <= IDLE_LOOP_LENGTH)
+        check_idle_loop(address, PC - 2, 2);
+    
+    PC = address;
+}
 
-            // LDX - Load X Register
-            // Flags: Z, N
-            
-            case LDX: {
-                //puts("LDX");
-                X = mem.read(address);
-                Z = X;
-                N = (X >> 7) & 1;
-                break;
-            }       
+// BPL - Branch if Positive
+// Flags: none
 
-            // LDY - Load Y Register
-            // Flags: Z, N
-            
-            case LDY: {
-                //puts("LDY");
-                Y = mem.read(address);
-                Z = Y;
-                N = (Y >> 7) & 1;
-                break;
-            }
+void CPU::op_BPL(Word operand) {
+    if(N == 0) branch(operand);
+}
 
-            // LSR - Logical Shift Right
-            // Flags: C, Z, N
-            
-            case LSR: {
-                //puts("LSR");
-                if(opcode_data[opcode][ADDRESS_MODE] == ACCUMULATOR) {
-                    C = A & 1;
-                    A = (A >> 1) & 0xFF;
-                    Z = A;
-                    N = (A >> 7) & 1;
-                }
-                else {
-                    short temp1 = mem.read(address);
-                    C = temp1 & 1;
-                    temp1 = (temp1 >> 1) & 0xFF;
-                    Z = temp1;
-                    N = (temp1 >> 7) & 1;
-                    mem.write((temp1 & 0xFF), address);
-                }
-                break;
-            }
-                
-            // NOP - No Operation
-            
-            case NOP: {
-                //puts("NOP");
-                // Move along, nothing to see here...
-                break;
-            }       
+// BMI - Branch if Minus
+// Flags: none
 
-            // ORA - Logical Inclusive OR
-            // Flags: Z, N
-            
-            case ORA: {
-                //puts("ORA");
-                short temp1 = (A | mem.read(address)) & 0xFF;
-                Z = temp1;
-                N = (temp1 >> 7) & 1;
-                A = temp1;
-                break;
-            }
-                
-            // TAX - Transfer Accumulator to X
-            // Flags: Z, N
-            
-            case TAX: {
-                //puts("TAX");
-                X = A;
-                Z = X;
-                N = (X >> 7) & 1;
-                break;
-            }
-                
-            // TXA - Transfer X to Accumulator
-            // Flags: Z, N
-            
-            case TXA: {
-                //puts("TXA");
-                A = X;
-                Z = A;
-                N = (A >> 7) & 1;
-                break;
-            }   
+void CPU::op_BMI(Word operand) {
+    if(N != 0) branch(operand);
+}
 
-            // DEX - Decrement X Register
-            // Flags: Z, N
-            
-            case DEX: {
-                //puts("DEX");
-                X = (X - 1) & 0xFF;
-                Z = X;
-                N = (X >> 7) & 1;
-                break;
-            }   
+// BVC - Branch if Overflow Clear
+// Flags: none
 
-            // INX - Increment X Register
-            // Flags: Z, N
-            
-            case INX: {
-                //puts("INX");
-                X = (X + 1) & 0xFF;
-                Z = X;
-                N = (X >> 7) & 1;
-                break;
-            }       
+void CPU::op_BVC(Word operand) {
+    if(V == 0) branch(operand);
+}
 
-            // TAY - Transfer Accumulator to Y
-            // Flags: Z, N
-            
-            case TAY: {
-                //puts("TAY");
-                Y = A;
-                Z = Y;
-                N = (Y >> 7) & 1;
-                break;
-            }
-                
-            // TYA - Transfer Y to Accumulator
-            // Flags: Z, N
-            
-            case TYA: {
-                //puts("TYA");
-                A = Y;
-                Z = A;
-                N = (A >> 7) & 1;
-                break;
-            }
-                
-            // DEY - Decrement Y Register
-            // Flags: Z, N
-            
-            case DEY: {
-                //puts("DEY");
-                Y = (Y - 1) & 0xFF;
-                Z = Y;
-                N = (Y >> 7) & 1;
-                break;
-            }
-                
-            // INY - Increment Y Register
-            // Flags: Z, N
-            
-            case INY: {
-                //puts("INY"); 
-                Y = (Y + 1) & 0xFF;
-                Z = Y;
-                N = (Y >> 7) & 1;
-                break;
-            }           
+// BVS - Branch if Overflow Set
+// Flags: none
 
-            // ROL - Rotate Left
-            // Flags: C, Z, N
-            
-            case ROL: {
-                //puts("ROL");
-                if(opcode_data[opcode][ADDRESS_MODE] == ACCUMULATOR) {
-                    short temp1 = A;
-                    short temp2 = C;
-                    C = (temp1 >> 7) & 1;
-                    temp1 = ((temp1 << 1) & 0xFF) + temp2;
-                    A = temp1;
-                    Z = A;
-                    N = (A >> 7) & 1;
-                }
-                else {
-                    short temp1 = mem.read(address);
-                    short temp2 = C;
-                    C = (temp1 >> 7) & 1;
-                    temp1 = ((temp1 << 1) & 0xFF) + temp2;
-                    Z = temp1;
-                    N = (temp1 >> 7) & 1;
-                    mem.write((temp1 & 0xFF), address);
-                }
-                break;
-            }
+void CPU::op_BVS(Word operand) {
+    if(V != 0) branch(operand);
+}
+
+// BCC - Branch if Carry Clear
+// Flags: none
+
+void CPU::op_BCC(Word operand) {
+    if(C == 0) branch(operand);
+}
+
+// BCS - Branch if Carry Set
+// Flags: none
+
+void CPU::op_BCS(Word operand) {
+    if(C != 0) branch(operand);
+}
+
+// BNE - Branch if Not Equal
+// Flags: none
+
+void CPU::op_BNE(Word operand) {
+    if(Z != 0) branch(operand);
+}
+
+// BEQ - Branch if Equal
+// Flags: none
+
+void CPU::op_BEQ(Word operand) {
+    if(Z == 0) branch(operand);
+}
+
+// BRK - Force Interrupt
+// Flags: B
+
+void CPU::op_BRK(Word operand) {
+    stack_push_word(PC + 1);
+    B = 1; // Flags pushed with B set
+    stack_push(pack_flags());
+    I = 1;
+    PC = mem.read_word(IRQ_VECTOR);
+}
+
+// CMP - Compare
+// Flags: Z, C, N
+
+template<int MODE>
+void CPU::op_CMP(Word operand) {
+    short temp1 = A - load<MODE>(operand);
+    C = temp1 >= 0 ? 1 : 0;
+    Z = temp1 & 0xFF;
+    N = (temp1 >> 7) & 1;
+}
+
+// CPX - Compare X Register
+// Flags: Z, C, N
+
+template<int MODE>
+void CPU::op_CPX(Word operand) {
+    short temp1 = X - load<MODE>(operand);
+    C = temp1 >= 0 ? 1 : 0;
+    Z = temp1 & 0xFF;
+    N = (temp1 >> 7) & 1;
+}
+
+// CPY - Compare Y Register
+// Flags: Z, C, N
+
+template<int MODE>
+void CPU::op_CPY(Word operand) {
+    short temp1 = Y - load<MODE>(operand);
+    C = temp1 >= 0 ? 1 : 0;
+    Z = temp1 & 0xFF;
+    N = (temp1 >> 7) & 1;
+}
+
+// DEC - Decrement Memory
+// Flags: Z, N
+
+template<int MODE>
+void CPU::op_DEC(Word operand) {
+    Word address = CPU::address<MODE>(operand);
+    short temp1 = (mem.read(address) - 1) & 0xFF;
+    Z = temp1;
+    N = (temp1 >> 7) & 1;
+    write((temp1 & 0xFF), address);
+}
+
+// EOR - Exclusive OR
+// Flags: Z, N
+
+template<int MODE>
+void CPU::op_EOR(Word operand) {
+    A ^= load<MODE>(operand) & 0xFF;
+    Z = A;
+    N = (A >> 7) & 1;
+}
+
+// CLC - Clear Carry Flag
+// Flags: C
+
+void CPU::op_CLC(Word operand) {
+    C = 0;
+}
+
+// SEC - Set Carry Flag
+// Flags: C
+
+void CPU::op_SEC(Word operand) {
+    C = 1;
+}
+
+// CLI - Clear Interrupt Disable
+// Flags: I
+
+void CPU::op_CLI(Word operand) {
+    I = 0;
+    stop_for_interrupt();
+}
+
+// SEI - Set Interrupt Disable
+// Flags: I
+
+void CPU::op_SEI(Word operand) {
+    I = 1;
+}
+
+// CLV - Clear Overflow Flag
+// Flags: V
+
+void CPU::op_CLV(Word operand) {
+    V = 0;
+}
+
+// CLD - Clear Decimal Mode
+// Flags: D
+
+void CPU::op_CLD(Word operand) {
+    D = 0;
+}
+
+// SED - Set Decimal Flag
+// Flags: D
+
+void CPU::op_SED(Word operand) {
+    D = 1;
+}
+
+// INC - Increment Memory
+// Flags: Z, N
+
+template<int MODE>
+void CPU::op_INC(Word operand) {
+    Word address = CPU::address<MODE>(operand);
+    short temp1 = (mem.read(address) + 1) & 0xFF;
+    Z = temp1;
+    N = (temp1 >> 7) & 1;
+    write((temp1 & 0xFF), address);
+}
+
+// JMP - Jump - check this
+// Flags: none
+
+template<int MODE>
+void CPU::op_JMP(Word operand) {
+    Word address = CPU::address<MODE>(operand);
+    
+    if(MODE == ABSOLUTE && address < PC && PC - address <= IDLE_LOOP_LENGTH)
+        check_idle_loop(address, PC - 3, 3);
+    
+    PC = address;
+}
+
+// JSR - Jump to Subroutine - check this
+// Flags: none
+
+void CPU::op_JSR(Word operand) {
+    stack_push_word(PC - 1);
+    PC = operand;
+}
+
+// LDA - Load Accumulator
+// Flags: Z, N
+
+template<int MODE>
+void CPU::op_LDA(Word operand) {
+    A = load<MODE>(operand);
+    Z = A;
+    N = (A >> 7) & 1;
+}
+
+// LDX - Load X Register
+// Flags: Z, N
+
+template<int MODE>
+void CPU::op_LDX(Word operand) {
+    X = load<MODE>(operand);
+    Z = X;
+    N = (X >> 7) & 1;
+}
+
+// LDY - Load Y Register
+// Flags: Z, N
+
+template<int MODE>
+void CPU::op_LDY(Word operand) {
+    Y = load<MODE>(operand);
+    Z = Y;
+    N = (Y >> 7) & 1;
+}
+
+// LSR - Logical Shift Right
+// Flags: C, Z, N
+
+template<int MODE>
+void CPU::op_LSR(Word operand) {
+    if(MODE == ACCUMULATOR) {
+        C = A & 1;
+        A = (A >> 1) & 0xFF;
+        Z = A;
+        N = (A >> 7) & 1;
+    }
+    else {
+        Word address = CPU::address<MODE>(operand);
+        short temp1 = mem.read(address);
+        C = temp1 & 1;
+        temp1 = (temp1 >> 1) & 0xFF;
+        Z = temp1;
+        N = (temp1 >> 7) & 1;
+        write((temp1 & 0xFF), address);
+    }
+}
+
+// NOP - No Operation
+
+void CPU::op_NOP(Word operand) {
+    // Move along, nothing to see here...
+}
+
+// ORA - Logical Inclusive OR
+// Flags: Z, N
+
+template<int MODE>
+void CPU::op_ORA(Word operand) {
+    short temp1 = (A | load<MODE>(operand)) & 0xFF;
+    Z = temp1;
+    N = (temp1 >> 7) & 1;
+    A = temp1;
+}
+
+// TAX - Transfer Accumulator to X
+// Flags: Z, N
+
+void CPU::op_TAX(Word operand) {
+    X = A;
+    Z = X;
+    N = (X >> 7) & 1;
+}
+
+// TXA - Transfer X to Accumulator
+// Flags: Z, N
+
+void CPU::op_TXA(Word operand) {
+    A = X;
+    Z = A;
+    N = (A >> 7) & 1;
+}
+
+// DEX - Decrement X Register
+// Flags: Z, N
+
+void CPU::op_DEX(Word operand) {
+    X = (X - 1) & 0xFF;
+    Z = X;
+    N = (X >> 7) & 1;
+}
+
+// INX - Increment X Register
+// Flags: Z, N
+
+void CPU::op_INX(Word operand) {
+    X = (X + 1) & 0xFF;
+    Z = X;
+    N = (X >> 7) & 1;
+}
+
+// TAY - Transfer Accumulator to Y
+// Flags: Z, N
+
+void CPU::op_TAY(Word operand) {
+    Y = A;
+    Z = Y;
+    N = (Y >> 7) & 1;
+}
+
+// TYA - Transfer Y to Accumulator
+// Flags: Z, N
+
+void CPU::op_TYA(Word operand) {
+    A = Y;
+    Z = A;
+    N = (A >> 7) & 1;
+}
+
+// DEY - Decrement Y Register
+// Flags: Z, N
+
+void CPU::op_DEY(Word operand) {
+    Y = (Y - 1) & 0xFF;
+    Z = Y;
+    N = (Y >> 7) & 1;
+}
+
+// INY - Increment Y Register
+// Flags: Z, N
+
+void CPU::op_INY(Word operand) {
+    Y = (Y + 1) & 0xFF;
+    Z = Y;
+    N = (Y >> 7) & 1;
+}
+
+// ROL - Rotate Left
+// Flags: C, Z, N
+
+template<int MODE>
+void CPU::op_ROL(Word operand) {
+    if(MODE == ACCUMULATOR) {
+        short temp1 = A;
+        short temp2 = C;
+        C = (temp1 >> 7) & 1;
+        temp1 = ((temp1 << 1) & 0xFF) + temp2;
+        A = temp1;
+        Z = A;
+        N = (A >> 7) & 1;
+    }
+    else {
+        Word address = CPU::address<MODE>(operand);
+        short temp1 = mem.read(address);
+        short temp2 = C;
+        C = (temp1 >> 7) & 1;
+        temp1 = ((temp1 << 1) & 0xFF) + temp2;
+        Z = temp1;
+        N = (temp1 >> 7) & 1;
+        write((temp1 & 0xFF), address);
+    }
+}
+
+// ROR - Rotate Right
+// Flags: C, Z, N
+
+template<int MODE>
+void CPU::op_ROR(Word operand) {
+    if(MODE == ACCUMULATOR) {
+        short temp1 = A;
+        short temp2 = C << 7;
+        C = temp1 & 1;
+        temp1 = (temp1 >> 1) + temp2;
+        A = temp1;
+        Z = A;
+        N = (A >> 7) & 1;
+    }
+    else {
+        Word address = CPU::address<MODE>(operand);
+        short temp1 = mem.read(address);
+        short temp2 = C << 7;
+        C = temp1 & 1;
+        temp1 = (temp1 >> 1) + temp2;
+        Z = temp1;
+        N = (temp1 >> 7) & 1;
+        write((temp1 & 0xFF), address);
+    }
+}
+
+// RTI - Return from Interrupt
+// Flags: set from stack
+
+void CPU::op_RTI(Word operand) {
+    unpack_flags(stack_pull());
+    PC = stack_pull_word() & 0xFFFF;
+    stop_for_interrupt();
+}
+
+// RTS - Return from Subroutine
+// Flags: none
+
+void CPU::op_RTS(Word operand) {
+    // Check this, it isn't working properly
+    PC = (stack_pull_word() + 1) & 0xFFFF;
+}
+
+// SBC - Subtract with Carry
+// Flags: Z, C, N, V
+
+template<int MODE>
+void CPU::op_SBC(Word operand) {
+    Byte value = load<MODE>(operand);
+    short temp1 = A - value - (1 - C);
+    Z = temp1 & 0xFF;
+    C = temp1 < 0 ? 0 : 1;
+    N = (temp1 >> 7) & 1;
+    V = (((((A ^ value) & 0x80) != 0)
+        && (((A ^ temp1) & 0x80)) != 0) ? 1 : 0);
+    A = temp1 & 0xFF;
+}
+
+// STA - Store Accumulator
+// Flags: none
+
+template<int MODE>
+void CPU::op_STA(Word operand) {
+    write(A, address<MODE>(operand));
+}
+
+// STX - Store X Register
+// Flags: none
+
+template<int MODE>
+void CPU::op_STX(Word operand) {
+    write(X, address<MODE>(operand));
+}
+
+// STY - Store Y Register
+// Flags: none
+
+template<int MODE>
+void CPU::op_STY(Word operand) {
+    write(Y, address<MODE>(operand));
+}
+
+// TXS - Transfer X to Stack Pointer
+// Flags: none
+
+void CPU::op_TXS(Word operand) {
+    S = X;
+}
+
+// TSX - Transfer Stack Pointer to X
+// Flags: Z, N
+
+void CPU::op_TSX(Word operand) {
+    X = S;
+    Z = X;
+    N = (S >> 7) & 1;
+}
+
+// PHA - Push Accumulator
+// Flags: none
+
+void CPU::op_PHA(Word operand) {
+    stack_push(A);
+}
+
+// PLA - Pull Accumulator
+// Flags: Z, N
+
+void CPU::op_PLA(Word operand) {
+    A = stack_pull();
+    Z = A;
+    N = (A >> 7) & 1;
+}
+
+// PHP - Push Processor Status
+// Flags: none
+
+void CPU::op_PHP(Word operand) {
+    stack_push(pack_flags());
+}
+
+// PLP - Pull Processor Status
+// Flags: all (set from stack)
+
+void CPU::op_PLP(Word operand) {
+    unpack_flags(stack_pull());
+    stop_for_interrupt();
+}
+
+// Halt on a nutty opcode. Stops the CPU rather than the program, so one
+// bad ROM can't take down a batch of runs. Reported on stderr, away from
+// the batch results. Maybe trigger a reset...
+void CPU::op_invalid(Word operand) {
+    PC--;
+    fprintf(stderr, "Invalid opcode: %X. Halting...\n", mem.read(PC));
+    halted = true;
+    cycles_left = 0;
+}
+
+// Recompiler
+//
+// Hot basic blocks in PRG-ROM are translated into x86-64 code. Most
+// instructions become a direct call to their handler with the operand as
+// an immediate, register-only instructions are generated inline. A block
+// ends at the first branch, jump, return or BRK, and returns the base
+// cycles it executed; handlers add extra cycles to cycle_count as usual.
+//
+// Code in RAM ($0000-$07FF) may be self-modifying, so it is always
+// interpreted. So are blocks that address the registers at $2000-$401F
+// directly. A block also exits early after a store to a mapper register,
+// or any indexed or indirect store that turns out to have hit one of the
+// register ranges.
+
+#if defined(__x86_64__) && defined(__GNUC__)
+
+static inline void emit8(Byte*& code, Byte b) {
+    *code++ = b;
+}
+
+static inline void emit16(Byte*& code, Word w) {
+    memcpy(code, &w, 2); code += 2;
+}
+
+static inline void emit32(Byte*& code, int i) {
+    memcpy(code, &i, 4); code += 4;
+}
+
+static inline void emit64(Byte*& code, const void* p) {
+    memcpy(code, &p, 8); code += 8;
+}
+
+// mov byte [rbx + offset], value
+static inline void emit_store_imm(Byte*& code, int offset, Byte value) {
+    emit8(code, 0xC6); emit8(code, 0x83); emit32(code, offset); emit8(code, value);
+}
+
+// mov al, [rbx + offset]
+static inline void emit_load_al(Byte*& code, int offset) {
+    emit8(code, 0x8A); emit8(code, 0x83); emit32(code, offset);
+}
+
+// mov [rbx + offset], al
+static inline void emit_store_al(Byte*& code, int offset) {
+    emit8(code, 0x88); emit8(code, 0x83); emit32(code, offset);
+}
+
+// Set Z and N from al, using this emulator's Z convention (Z == result)
+static inline void emit_set_ZN(Byte*& code, int z, int n) {
+    emit8(code, 0x84); emit8(code, 0xC0);                       // test al, al
+    emit8(code, 0x0F); emit8(code, 0x95); emit8(code, 0x83);    // setne [rbx + z]
+    emit32(code, z);
+    emit8(code, 0xC0); emit8(code, 0xE8); emit8(code, 0x07);    // shr al, 7
+    emit_store_al(code, n);
+}
+
+// Set PC, return the cycles executed so far and leave the block
+static inline void emit_exit(Byte*& code, int pc, Word address, int cycles) {
+    emit8(code, 0x66); emit8(code, 0xC7); emit8(code, 0x83);    // mov word [rbx + pc], address
+    emit32(code, pc); emit16(code, address);
+    emit8(code, 0xB8); emit32(code, cycles);                    // mov eax, cycles
+    emit8(code, 0x5B);                                          // pop rbx
+    emit8(code, 0xC3);                                          // ret
+}
+
+#endif
+
+// Other hosts keep to the interpreter, with no code cache mapped
+bool CPU::enable_recompiler() {
+#if defined(__x86_64__) && defined(__GNUC__)
+    if(blocks) return true;
+    
+    code_cache = (Byte*) mmap(0, CODE_CACHE_SIZE,
+        PROT_READ | PROT_WRITE | PROT_EXEC,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    
+    if(code_cache == MAP_FAILED) {
+        code_cache = 0;
+        return false;
+    }
+    
+    blocks = new Block[0x8000];
+    flush_code_cache();
+    
+    return true;
+#else
+    return false;
+#endif
+}
+
+void CPU::flush_code_cache() {
+    memset(blocks, 0, sizeof(Block) * 0x8000);
+    code_cache_used = 0;
+}
+
+// Same as emulate(), but runs compiled blocks where it can. A block is
+// only entered if it can't overrun the cycle budget before its last
+// instruction, so timing matches the interpreter exactly.
+// Interrupts are dispatched as in emulate()
+long CPU::emulate_recompiled() {
+    do {
+        cycle_count = 0;
+        
+        handle_interrupt();
+        
+        do {
+            if(PC >= 0x8000) {
+                Block &block = blocks[PC - 0x8000];
+                Word generation = bank_generation[(PC >> 13) & 3];
                 
-            // ROR - Rotate Right
-            // Flags: C, Z, N
-            
-            case ROR: {
-                //puts("ROR");
-                if(opcode_data[opcode][ADDRESS_MODE] == ACCUMULATOR) {
-                    short temp1 = A;
-                    short temp2 = C << 7;
-                    C = temp1 & 1;
-                    temp1 = (temp1 >> 1) + temp2;
-                    A = temp1;
-                    Z = A;
-                    N = (A >> 7) & 1;
+                // Compiled from a bank that has since been switched out
+                if(block.generation != generation) {
+                    block.code = 0;
+                    block.heat = 0;
+                    block.generation = generation;
                 }
-                else {
-                    short temp1 = mem.read(address);
-                    short temp2 = C << 7;
-                    C = temp1 & 1;
-                    temp1 = (temp1 >> 1) + temp2;
-                    Z = temp1;
-                    N = (temp1 >> 7) & 1;
-                    mem.write((temp1 & 0xFF), address);
-                }
-                break;
-            }
                 
-            // RTI - Return from Interrupt
-            // Flags: set from stack
-            
-            case RTI: {
-                //puts("RTI");
-                unpack_flags(stack_pull());
-                PC = stack_pull_word() & 0xFFFF;
-                break;
+                if(block.code) {
+                    if(cycles_left - cycle_count > block.budget) {
+                        mem.clear_io_write_flag();
+                        cycles_left -= block.code(this) + cycle_count;
+                        block_cycles = 0;
+                        cycle_count = 0;
+                        instructions_run += block.length;
+                        continue;
+                    }
+                }
+                else if(block.heat < BLOCK_HOT && ++block.heat == BLOCK_HOT)
+                    compile_block(PC);
             }
-
-            // RTS - Return from Subroutine
-            // Flags: none
             
-            case RTS: {
-                //puts("RTS");
-                // Check this, it isn't working properly
-                PC = (stack_pull_word() + 1) & 0xFFFF;
-                break;
-            }       
+            cycles_left -= step();
+            cycle_count = 0;
+            instructions_run++;
+        } while(cycles_left > 0);
+    } while(resume_after_interrupt());
+    
+    return cycles_left;
+}
 
-            // SBC - Subtract with Carry
-            // Flags: Z, C, N, V
+void CPU::compile_block(Word start) {
+#if defined(__x86_64__) && defined(__GNUC__)
+    Block &block = blocks[start - 0x8000];
+    
+    // Make sure the largest possible block will fit
+    if(code_cache_used + MAX_BLOCK_LENGTH * 64 + 64 > CODE_CACHE_SIZE) {
+        flush_code_cache();
+        block.heat = BLOCK_HOT;
+        block.generation = bank_generation[(start >> 13) & 3];
+    }
+    
+    // Offsets of the registers and flags the generated code touches
+    Byte* base = (Byte*) this;
+    int a = (Byte*) &A - base, x = (Byte*) &X - base, y = (Byte*) &Y - base;
+    int s = (Byte*) &S - base, pc = (Byte*) &PC - base;
+    int z = (Byte*) &Z - base, n = (Byte*) &N - base;
+    
+    const bool* io_written = mem.get_io_write_flag();
+    
+    Byte* code = code_cache + code_cache_used;
+    Byte* entry = code;
+    
+    emit8(code, 0x53);                                  // push rbx
+    emit8(code, 0x48); emit8(code, 0x89); emit8(code, 0xFB); // mov rbx, rdi
+    
+    Word address = start;
+    int cycles = 0;
+    int budget = 0;
+    int length = 0;
+    bool jumps = false;
+    
+    for(int count = 0; count < MAX_BLOCK_LENGTH; count++) {
+        Byte opcode = mem.read(address);
+        
+        // Leave invalid opcodes to the interpreter to report
+        if(opcode_data[opcode][INSTRUCTION] == 0xFF) break;
+        
+        const Opcode &op = opcodes[opcode];
+        
+        // Keep within the block's bank, so switching it retires the block
+        if(((address + op.length - 1) >> 13) != (start >> 13)) break;
+        
+        Word operand = 0;
+        if(op.length == 2) operand = mem.read(address + 1);
+        else if(op.length == 3) operand = mem.read_word(address + 1);
+        
+        Byte instruction = opcode_data[opcode][INSTRUCTION];
+        Byte mode = opcode_data[opcode][ADDRESS_MODE];
+        
+        // Direct access to the registers - interpret the whole block
+        if((mode == ABSOLUTE || mode == INDIRECT)
+            && operand >= 0x2000 && operand < 0x4020) {
+            block.heat = 0xFF;
+            return;
+        }
+        
+        Word next = address + op.length;
+        
+        bool ends_block = false;
+        
+        switch(instruction) {
+            case CLC: emit_store_imm(code, (Byte*) &C - base, 0); break;
+            case SEC: emit_store_imm(code, (Byte*) &C - base, 1); break;
+            case SEI: emit_store_imm(code, (Byte*) &I - base, 1); break;
+            case CLV: emit_store_imm(code, (Byte*) &V - base, 0); break;
+            case CLD: emit_store_imm(code, (Byte*) &D - base, 0); break;
+            case SED: emit_store_imm(code, (Byte*) &D - base, 1); break;
+            case NOP: break;
+            
+            case TAX: emit_load_al(code, a); emit_store_al(code, x); emit_set_ZN(code, z, n); break;
+            case TAY: emit_load_al(code, a); emit_store_al(code, y); emit_set_ZN(code, z, n); break;
+            case TXA: emit_load_al(code, x); emit_store_al(code, a); emit_set_ZN(code, z, n); break;
+            case TYA: emit_load_al(code, y); emit_store_al(code, a); emit_set_ZN(code, z, n); break;
+            case TSX: emit_load_al(code, s); emit_store_al(code, x); emit_set_ZN(code, z, n); break;
+            case TXS: emit_load_al(code, x); emit_store_al(code, s); break;
+            
+            // inc al / dec al
+            case INX: emit_load_al(code, x); emit8(code, 0xFE); emit8(code, 0xC0);
+                emit_store_al(code, x); emit_set_ZN(code, z, n); break;
+            case INY: emit_load_al(code, y); emit8(code, 0xFE); emit8(code, 0xC0);
+                emit_store_al(code, y); emit_set_ZN(code, z, n); break;
+            case DEX: emit_load_al(code, x); emit8(code, 0xFE); emit8(code, 0xC8);
+                emit_store_al(code, x); emit_set_ZN(code, z, n); break;
+            case DEY: emit_load_al(code, y); emit8(code, 0xFE); emit8(code, 0xC8);
+                emit_store_al(code, y); emit_set_ZN(code, z, n); break;
             
-            case SBC: {
-                //puts("SBC");
-                short temp1 = A - mem.read(address) - (1 - C);
-                Z = temp1 & 0xFF;
-                C = temp1 < 0 ? 0 : 1;
-                N = (temp1 >> 7) & 1;
-                V = (((((A ^ mem.read(address)) & 0x80) != 0)
-                    && (((A ^ temp1) & 0x80)) != 0) ? 1 : 0);
-                A = temp1 & 0xFF;   
-                break;
-            }
+            default: {
+                bool immediate_load = mode == IMMEDIATE
+                    && (instruction == LDA || instruction == LDX || instruction == LDY);
                 
-            // STA - Store Accumulator
-            // Flags: none
-            
-            case STA: {
-                //puts("STA");
-                mem.write(A, address);
-                break;
-            }
+                // Immediate loads are constants
+                if(immediate_load) {
+                    int reg = instruction == LDA ? a : (instruction == LDX ? x : y);
+                    emit_store_imm(code, reg, operand);
+                    emit_store_imm(code, z, operand != 0);
+                    emit_store_imm(code, n, (operand >> 7) & 1);
+                    break;
+                }
                 
-            // STX - Store X Register
-            // Flags: none
-            
-            case STX: {
-                //puts("STX");
-                mem.write(X, address);
-                break;
-            }
+                switch(instruction) {
+                    case BCC: case BCS: case BEQ: case BMI: case BNE:
+                    case BPL: case BVC: case BVS: case BRK: case JMP:
+                    case JSR: case RTI: case RTS:
+                        ends_block = true;
+                        // Handlers work relative to the following instruction
+                        emit8(code, 0x66); emit8(code, 0xC7); emit8(code, 0x83);
+                        emit32(code, pc); emit16(code, next);
+                        break;
+                }
                 
-            // STY - Store Y Register
-            // Flags: none
-            
-            case STY: {
-                //puts("STY");
-                mem.write(Y, address);
-                break;
-            }
+                // Branches and jumps may check for an idle loop, indexed
+                // accesses may hit a register, and clearing I may stop the
+                // run for an interrupt, which need the cycles run so far:
+                // mov dword [rbx + block_cycles], cycles
+                if(mode == RELATIVE || instruction == JMP
+                    || mode == ABSOLUTE_X || mode == ABSOLUTE_Y
+                    || mode == INDIRECT_X || mode == INDIRECT_Y
+                    || mode == ABSOLUTE || instruction == CLI
+                    || instruction == PLP || instruction == RTI) {
+                    emit8(code, 0xC7); emit8(code, 0x83);
+                    emit32(code, (Byte*) &block_cycles - base);
+                    emit32(code, cycles);
+                }
                 
-            // TXS - Transfer X to Stack Pointer
-            // Flags: none
-            
-            case TXS: {
-                //puts("TXS");
-                S = X;
-                break;
-            }
+                // Call the handler: handler(this, operand)
+                union { Handler handler; void* function; } target;
+                target.handler = op.execute;
                 
-            // TSX - Transfer Stack Pointer to X
-            // Flags: Z, N
-            
-            case TSX: {
-                //puts("TSX");
-                X = S;
-                Z = X;
-                N = (S >> 7) & 1;
-                break;
-            }   
-
-            // PHA - Push Accumulator
-            // Flags: none
-            
-            case PHA: {
-                //puts("PHA");
-                stack_push(A);
-                break;
-            }
+                emit8(code, 0x48); emit8(code, 0x89); emit8(code, 0xDF); // mov rdi, rbx
+                emit8(code, 0xBE); emit32(code, operand);               // mov esi, operand
+                emit8(code, 0x48); emit8(code, 0xB8);                   // mov rax, handler
+                emit64(code, target.function);
+                emit8(code, 0xFF); emit8(code, 0xD0);                   // call rax
                 
-            // PLA - Pull Accumulator
-            // Flags: Z, N
-            
-            case PLA: {
-                //puts("PLA");
-                A = stack_pull();
-                Z = A;
-                N = (A >> 7) & 1;
-                break;
+                // Indexed and indirect stores may land on a register
+                bool writes = instruction == STA || instruction == STX
+                    || instruction == STY || instruction == ASL
+                    || instruction == LSR || instruction == ROL
+                    || instruction == ROR || instruction == INC
+                    || instruction == DEC;
+                
+                if(writes && (mode == ABSOLUTE_X || mode == ABSOLUTE_Y
+                    || mode == INDIRECT_X || mode == INDIRECT_Y
+                    || (mode == ABSOLUTE && operand >= 0x8000))) {
+                    emit8(code, 0x48); emit8(code, 0xB8);           // mov rax, io_written
+                    emit64(code, io_written);
+                    emit8(code, 0x80); emit8(code, 0x38); emit8(code, 0x00); // cmp byte [rax], 0
+                    emit8(code, 0x74); emit8(code, 16);             // je over the exit
+                    emit_exit(code, pc, next, cycles + op.time);
+                }
             }
-
-            // PHP - Push Processor Status
-            // Flags: none
-            
-            case PHP: {
-                //puts("PHP");
-                stack_push(pack_flags());
-                break;
-            }   
-
-            // PLP - Pull Processor Status
-            // Flags: all (set from stack)
-            
-            case PLP: {
-                //puts("PLP");
-                unpack_flags(stack_pull());
-                break;
-            }   
-            
-            // Get out of here if we find a nutty opcode
-             
-            default: {
-                // Maybe trigger a reset...
-                printf("Invalid opcode: %X. Exiting...\n", opcode);
-                exit(-1);
-            }       
         }
         
-        // Subtract the number of cycles used by the instruction + 
-        // the extra cycles
-        cycles -= (opcode_data[opcode][OP_TIME] + cycle_count);
+        cycles += op.time;
+        address = next;
+        length++;
         
-        //print_regs();
+        if(ends_block) {
+            jumps = true;
+            break;
+        }
+        
+        // Worst case cycles up to here, extras for page crossing included
+        budget += op.time + (mode == ABSOLUTE_X || mode == ABSOLUTE_Y
+            || mode == INDIRECT_X || mode == INDIRECT_Y);
+        
+        // Clearing I may let a waiting IRQ in, which stops the run, but
+        // only once the block is over
+        if(instruction == CLI || instruction == PLP) break;
+    }
+    
+    // Nothing worth compiling
+    if(address == start) {
+        block.heat = 0xFF;
+        return;
+    }
+    
+    // Control flow instructions have already set PC
+    if(jumps) {
+        emit8(code, 0xB8); emit32(code, cycles);        // mov eax, cycles
+        emit8(code, 0x5B);                              // pop rbx
+        emit8(code, 0xC3);                              // ret
     }
-    return cycles;
+    else emit_exit(code, pc, address, cycles);
+    
+    code_cache_used += code - entry;
+    
+    block.code = (BlockCode) entry;
+    block.budget = budget;
+    block.length = length;
+#endif
 }
 
 inline Byte CPU::pack_flags() {
@@ -1833,3 +2332,170 @@ void CPU::load_opcode_data() {
         }
     }*/
 }
+
+// Build the dispatch table. Each handler has its addressing mode baked in
+// at compile time; length and timing are taken from opcode_data.
+void CPU::load_opcodes() {
+    for(int i = 0; i < 0x100; i++) {
+        opcodes[i].execute = &CPU::op_invalid;
+        opcodes[i].length = 1;
+        opcodes[i].time = 0;
+        
+        if(opcode_data[i][INSTRUCTION] != 0xFF) {
+            opcodes[i].length = opcode_data[i][OP_LENGTH];
+            opcodes[i].time = opcode_data[i][OP_TIME];
+        }
+    }
+    
+    opcodes[0x00].execute = &CPU::op_BRK;
+    opcodes[0x01].execute = &CPU::op_ORA<INDIRECT_X>;
+    opcodes[0x05].execute = &CPU::op_ORA<ZERO_PAGE>;
+    opcodes[0x06].execute = &CPU::op_ASL<ZERO_PAGE>;
+    opcodes[0x08].execute = &CPU::op_PHP;
+    opcodes[0x09].execute = &CPU::op_ORA<IMMEDIATE>;
+    opcodes[0x0A].execute = &CPU::op_ASL<ACCUMULATOR>;
+    opcodes[0x0D].execute = &CPU::op_ORA<ABSOLUTE>;
+    opcodes[0x0E].execute = &CPU::op_ASL<ABSOLUTE>;
+    opcodes[0x10].execute = &CPU::op_BPL;
+    opcodes[0x11].execute = &CPU::op_ORA<INDIRECT_Y>;
+    opcodes[0x15].execute = &CPU::op_ORA<ZERO_PAGE_X>;
+    opcodes[0x16].execute = &CPU::op_ASL<ZERO_PAGE_X>;
+    opcodes[0x18].execute = &CPU::op_CLC;
+    opcodes[0x19].execute = &CPU::op_ORA<ABSOLUTE_Y>;
+    opcodes[0x1D].execute = &CPU::op_ORA<ABSOLUTE_X>;
+    opcodes[0x1E].execute = &CPU::op_ASL<ABSOLUTE_X>;
+    opcodes[0x20].execute = &CPU::op_JSR;
+    opcodes[0x21].execute = &CPU::op_AND<INDIRECT_X>;
+    opcodes[0x24].execute = &CPU::op_BIT<ZERO_PAGE>;
+    opcodes[0x25].execute = &CPU::op_AND<ZERO_PAGE>;
+    opcodes[0x26].execute = &CPU::op_ROL<ZERO_PAGE>;
+    opcodes[0x28].execute = &CPU::op_PLP;
+    opcodes[0x29].execute = &CPU::op_AND<IMMEDIATE>;
+    opcodes[0x2A].execute = &CPU::op_ROL<ACCUMULATOR>;
+    opcodes[0x2C].execute = &CPU::op_BIT<ABSOLUTE>;
+    opcodes[0x2D].execute = &CPU::op_AND<ABSOLUTE>;
+    opcodes[0x2E].execute = &CPU::op_ROL<ABSOLUTE>;
+    opcodes[0x30].execute = &CPU::op_BMI;
+    opcodes[0x31].execute = &CPU::op_AND<INDIRECT_Y>;
+    opcodes[0x35].execute = &CPU::op_AND<ZERO_PAGE_X>;
+    opcodes[0x36].execute = &CPU::op_ROL<ZERO_PAGE_X>;
+    opcodes[0x38].execute = &CPU::op_SEC;
+    opcodes[0x39].execute = &CPU::op_AND<ABSOLUTE_Y>;
+    opcodes[0x3D].execute = &CPU::op_AND<ABSOLUTE_X>;
+    opcodes[0x3E].execute = &CPU::op_ROL<ABSOLUTE_X>;
+    opcodes[0x40].execute = &CPU::op_RTI;
+    opcodes[0x41].execute = &CPU::op_EOR<INDIRECT_X>;
+    opcodes[0x45].execute = &CPU::op_EOR<ZERO_PAGE>;
+    opcodes[0x46].execute = &CPU::op_LSR<ZERO_PAGE>;
+    opcodes[0x48].execute = &CPU::op_PHA;
+    opcodes[0x49].execute = &CPU::op_EOR<IMMEDIATE>;
+    opcodes[0x4A].execute = &CPU::op_LSR<ACCUMULATOR>;
+    opcodes[0x4C].execute = &CPU::op_JMP<ABSOLUTE>;
+    opcodes[0x4D].execute = &CPU::op_EOR<ABSOLUTE>;
+    opcodes[0x4E].execute = &CPU::op_LSR<ABSOLUTE>;
+    opcodes[0x50].execute = &CPU::op_BVC;
+    opcodes[0x51].execute = &CPU::op_EOR<INDIRECT_Y>;
+    opcodes[0x55].execute = &CPU::op_EOR<ZERO_PAGE_X>;
+    opcodes[0x56].execute = &CPU::op_LSR<ZERO_PAGE_X>;
+    opcodes[0x58].execute = &CPU::op_CLI;
+    opcodes[0x59].execute = &CPU::op_EOR<ABSOLUTE_Y>;
+    opcodes[0x5D].execute = &CPU::op_EOR<ABSOLUTE_X>;
+    opcodes[0x5E].execute = &CPU::op_LSR<ABSOLUTE_X>;
+    opcodes[0x60].execute = &CPU::op_RTS;
+    opcodes[0x61].execute = &CPU::op_ADC<INDIRECT_X>;
+    opcodes[0x65].execute = &CPU::op_ADC<ZERO_PAGE>;
+    opcodes[0x66].execute = &CPU::op_ROR<ZERO_PAGE>;
+    opcodes[0x68].execute = &CPU::op_PLA;
+    opcodes[0x69].execute = &CPU::op_ADC<IMMEDIATE>;
+    opcodes[0x6A].execute = &CPU::op_ROR<ACCUMULATOR>;
+    opcodes[0x6C].execute = &CPU::op_JMP<INDIRECT>;
+    opcodes[0x6D].execute = &CPU::op_ADC<ABSOLUTE>;
+    opcodes[0x6E].execute = &CPU::op_ROR<ABSOLUTE>;
+    opcodes[0x70].execute = &CPU::op_BVS;
+    opcodes[0x71].execute = &CPU::op_ADC<INDIRECT_Y>;
+    opcodes[0x75].execute = &CPU::op_ADC<ZERO_PAGE_X>;
+    opcodes[0x76].execute = &CPU::op_ROR<ZERO_PAGE_X>;
+    opcodes[0x78].execute = &CPU::op_SEI;
+    opcodes[0x79].execute = &CPU::op_ADC<ABSOLUTE_Y>;
+    opcodes[0x7D].execute = &CPU::op_ADC<ABSOLUTE_X>;
+    opcodes[0x7E].execute = &CPU::op_ROR<ABSOLUTE_X>;
+    opcodes[0x81].execute = &CPU::op_STA<INDIRECT_X>;
+    opcodes[0x84].execute = &CPU::op_STY<ZERO_PAGE>;
+    opcodes[0x85].execute = &CPU::op_STA<ZERO_PAGE>;
+    opcodes[0x86].execute = &CPU::op_STX<ZERO_PAGE>;
+    opcodes[0x88].execute = &CPU::op_DEY;
+    opcodes[0x8A].execute = &CPU::op_TXA;
+    opcodes[0x8C].execute = &CPU::op_STY<ABSOLUTE>;
+    opcodes[0x8D].execute = &CPU::op_STA<ABSOLUTE>;
+    opcodes[0x8E].execute = &CPU::op_STX<ABSOLUTE>;
+    opcodes[0x90].execute = &CPU::op_BCC;
+    opcodes[0x91].execute = &CPU::op_STA<INDIRECT_Y>;
+    opcodes[0x94].execute = &CPU::op_STY<ZERO_PAGE_X>;
+    opcodes[0x95].execute = &CPU::op_STA<ZERO_PAGE_X>;
+    opcodes[0x96].execute = &CPU::op_STX<ZERO_PAGE_Y>;
+    opcodes[0x98].execute = &CPU::op_TYA;
+    opcodes[0x99].execute = &CPU::op_STA<ABSOLUTE_Y>;
+    opcodes[0x9A].execute = &CPU::op_TXS;
+    opcodes[0x9D].execute = &CPU::op_STA<ABSOLUTE_X>;
+    opcodes[0xA0].execute = &CPU::op_LDY<IMMEDIATE>;
+    opcodes[0xA1].execute = &CPU::op_LDA<INDIRECT_X>;
+    opcodes[0xA2].execute = &CPU::op_LDX<IMMEDIATE>;
+    opcodes[0xA4].execute = &CPU::op_LDY<ZERO_PAGE>;
+    opcodes[0xA5].execute = &CPU::op_LDA<ZERO_PAGE>;
+    opcodes[0xA6].execute = &CPU::op_LDX<ZERO_PAGE>;
+    opcodes[0xA8].execute = &CPU::op_TAY;
+    opcodes[0xA9].execute = &CPU::op_LDA<IMMEDIATE>;
+    opcodes[0xAA].execute = &CPU::op_TAX;
+    opcodes[0xAC].execute = &CPU::op_LDY<ABSOLUTE>;
+    opcodes[0xAD].execute = &CPU::op_LDA<ABSOLUTE>;
+    opcodes[0xAE].execute = &CPU::op_LDX<ABSOLUTE>;
+    opcodes[0xB0].execute = &CPU::op_BCS;
+    opcodes[0xB1].execute = &CPU::op_LDA<INDIRECT_Y>;
+    opcodes[0xB4].execute = &CPU::op_LDY<ZERO_PAGE_X>;
+    opcodes[0xB5].execute = &CPU::op_LDA<ZERO_PAGE_X>;
+    opcodes[0xB6].execute = &CPU::op_LDX<ZERO_PAGE_Y>;
+    opcodes[0xB8].execute = &CPU::op_CLV;
+    opcodes[0xB9].execute = &CPU::op_LDA<ABSOLUTE_Y>;
+    opcodes[0xBA].execute = &CPU::op_TSX;
+    opcodes[0xBC].execute = &CPU::op_LDY<ABSOLUTE_X>;
+    opcodes[0xBD].execute = &CPU::op_LDA<ABSOLUTE_X>;
+    opcodes[0xBE].execute = &CPU::op_LDX<ABSOLUTE_Y>;
+    opcodes[0xC0].execute = &CPU::op_CPY<IMMEDIATE>;
+    opcodes[0xC1].execute = &CPU::op_CMP<INDIRECT_X>;
+    opcodes[0xC4].execute = &CPU::op_CPY<ZERO_PAGE>;
+    opcodes[0xC5].execute = &CPU::op_CMP<ZERO_PAGE>;
+    opcodes[0xC6].execute = &CPU::op_DEC<ZERO_PAGE>;
+    opcodes[0xC8].execute = &CPU::op_INY;
+    opcodes[0xC9].execute = &CPU::op_CMP<IMMEDIATE>;
+    opcodes[0xCA].execute = &CPU::op_DEX;
+    opcodes[0xCC].execute = &CPU::op_CPY<ABSOLUTE>;
+    opcodes[0xCD].execute = &CPU::op_CMP<ABSOLUTE>;
+    opcodes[0xCE].execute = &CPU::op_DEC<ABSOLUTE>;
+    opcodes[0xD0].execute = &CPU::op_BNE;
+    opcodes[0xD1].execute = &CPU::op_CMP<INDIRECT_Y>;
+    opcodes[0xD5].execute = &CPU::op_CMP<ZERO_PAGE_X>;
+    opcodes[0xD6].execute = &CPU::op_DEC<ZERO_PAGE_X>;
+    opcodes[0xD8].execute = &CPU::op_CLD;
+    opcodes[0xD9].execute = &CPU::op_CMP<ABSOLUTE_Y>;
+    opcodes[0xDD].execute = &CPU::op_CMP<ABSOLUTE_X>;
+    opcodes[0xDE].execute = &CPU::op_DEC<ABSOLUTE_X>;
+    opcodes[0xE0].execute = &CPU::op_CPX<IMMEDIATE>;
+    opcodes[0xE1].execute = &CPU::op_SBC<INDIRECT_X>;
+    opcodes[0xE4].execute = &CPU::op_CPX<ZERO_PAGE>;
+    opcodes[0xE5].execute = &CPU::op_SBC<ZERO_PAGE>;
+    opcodes[0xE6].execute = &CPU::op_INC<ZERO_PAGE>;
+    opcodes[0xE8].execute = &CPU::op_INX;
+    opcodes[0xE9].execute = &CPU::op_SBC<IMMEDIATE>;
+    opcodes[0xEA].execute = &CPU::op_NOP;
+    opcodes[0xEC].execute = &CPU::op_CPX<ABSOLUTE>;
+    opcodes[0xED].execute = &CPU::op_SBC<ABSOLUTE>;
+    opcodes[0xEE].execute = &CPU::op_INC<ABSOLUTE>;
+    opcodes[0xF0].execute = &CPU::op_BEQ;
+    opcodes[0xF1].execute = &CPU::op_SBC<INDIRECT_Y>;
+    opcodes[0xF5].execute = &CPU::op_SBC<ZERO_PAGE_X>;
+    opcodes[0xF6].execute = &CPU::op_INC<ZERO_PAGE_X>;
+    opcodes[0xF8].execute = &CPU::op_SED;
+    opcodes[0xF9].execute = &CPU::op_SBC<ABSOLUTE_Y>;
+    opcodes[0xFD].execute = &CPU::op_SBC<ABSOLUTE_X>;
+    opcodes[0xFE].execute = &CPU::op_INC<ABSOLUTE_X>;
+}
@@ -11,16 +11,26 @@
 #include "Mapper.h"
 #include "PPU.h"
 
-// Interrupt types
-const int NMI           = 0;
-const int RESET         = 1;
-const int IRQ           = 2;
+// Interrupt lines, as bits of the pending interrupts. NMI is edge
+// triggered, and cleared once taken. IRQ is the OR of every source's
+// line, each held until its source lets go of it.
+const Byte NMI_LINE         = 0x01;
+const Byte MAPPER_IRQ_LINE  = 0x02;
+const Byte IRQ_LINES        = 0xFE;
 
 // Addresses of interrupt routines
 const Word NMI_VECTOR    = 0xFFFA;
 const Word RESET_VECTOR  = 0xFFFC;
 const Word IRQ_VECTOR    = 0xFFFE;
 
+// Recompiler settings
+const int BLOCK_HOT          = 8;        // runs before a block is compiled
+const int MAX_BLOCK_LENGTH   = 32;       // instructions
+const int CODE_CACHE_SIZE    = 0x400000;
+
+// Longest loop, in bytes, checked for idling
+const int IDLE_LOOP_LENGTH   = 32;
+
 class CPU {
 private:
     // opcode_data table index
@@ -66,6 +76,36 @@ private:
     // Opcode information table
     Byte opcode_data[0x100][4];
     
+    // Opcode handler, called with the instruction's operand bytes
+    typedef void (CPU::*Handler)(Word operand);
+    
+    struct Opcode {
+        Handler execute;
+        Byte length;
+        Byte time;
+    };
+    
+    // Dispatch table, one handler per opcode
+    Opcode opcodes[0x100];
+    
+    // Instruction decoded from PRG-ROM, ready to execute
+    struct Decoded {
+        Handler execute;
+        Word operand;
+        Byte length;
+        Byte time;
+        
+        // Generation of the bank it was decoded from, 0 if not cached
+        Word generation;
+    };
+    
+    // Decode cache, one entry per address in $8000-$FFFF
+    Decoded* decode_cache;
+    
+    // The 8KB PRG banks the caches were filled from, and their generation
+    const Byte* decoded_banks[4];
+    Word bank_generation[4];
+    
     // Registers
     Byte A;     // Accumulator
     Byte X;     // X index register
@@ -86,12 +126,166 @@ private:
     // Keep track of cycles to add
     unsigned int cycle_count;
     
-    // Current interrupt type
-    int interrupt;
+    // Interrupt lines set, see NMI_LINE
+    Byte interrupts;
+    
+    // Stopped by an invalid opcode
+    bool halted;
+    
+    // Budget given to, and left in, the current call to emulate()
+    long cycles_run;
+    long cycles_left;
+    
+    // Budget set aside while the run stops to take an interrupt, see
+    // stop_for_interrupt()
+    long cycles_held;
+    
+    // Instructions run since reset, for stats. Compiled blocks count all
+    // of theirs, even if they leave early.
+    long long instructions_run;
+    
+    // Base cycles run by the current compiled block before the
+    // instruction being executed, 0 when interpreting. Only kept up to
+    // date for instructions that need it: branches, jumps, those that
+    // may touch the registers, and those that may clear I.
+    int block_cycles;
+    
+    // Last loop checked for idling: from idle_head back from the branch
+    // or jump at idle_tail, and whether it only reads. Checked again on
+    // each call to emulate(), in case the code has changed.
+    Word idle_head;
+    Word idle_tail;
+    bool idle_loop;
+    bool idle_checked;
+    
+    // Passes seen through the loop with the same registers, and the
+    // registers, budget and pass length at the last one
+    int idle_passes;
+    unsigned int idle_regs;
+    Byte idle_flags;
+    long idle_position;
+    long idle_period;
+    
+    // Compiled block: native code, returning the base cycles it ran
+    typedef int (*BlockCode)(CPU* cpu);
+    
+    struct Block {
+        BlockCode code;
+        
+        // Cycle budget needed to run the block to completion
+        int budget;
+        
+        // Times reached by the interpreter, 0xFF if not compilable
+        Byte heat;
+        
+        // Generation of the bank it was compiled from
+        Word generation;
+        
+        // Instructions compiled into it
+        Byte length;
+    };
+    
+    // One per PRG-ROM address. Null unless the recompiler is enabled.
+    Block* blocks;
+    
+    // Executable memory for compiled blocks
+    Byte* code_cache;
+    int code_cache_used;
     
     void handle_interrupt();
     
-    Word get_operand_address(Byte opcode);
+    // Whether an interrupt is waiting that can be taken now
+    bool interrupt_ready() const {
+        return (interrupts & NMI_LINE) || ((interrupts & IRQ_LINES) && !I);
+    }
+    
+    void stop_for_interrupt();
+    bool resume_after_interrupt();
+    
+    int step();
+    
+    void write(Byte data, Word address);
+    
+    void decode(Decoded &decoded, Word address);
+    
+    void sync_PRG_banks();
+    
+    long emulate_recompiled();
+    
+    void compile_block(Word start);
+    
+    void flush_code_cache();
+    
+    template<int MODE> Word address(Word operand);
+    
+    template<int MODE> Byte load(Word operand);
+    
+    void branch(Word operand);
+    
+    bool is_idle_loop(Word head, Word tail);
+    
+    void check_idle_loop(Word head, Word tail, int time);
+    
+    // Instruction handlers, templated on addressing mode where the
+    // instruction has more than one
+    template<int MODE> void op_ADC(Word operand);
+    template<int MODE> void op_AND(Word operand);
+    template<int MODE> void op_ASL(Word operand);
+    template<int MODE> void op_BIT(Word operand);
+    template<int MODE> void op_CMP(Word operand);
+    template<int MODE> void op_CPX(Word operand);
+    template<int MODE> void op_CPY(Word operand);
+    template<int MODE> void op_DEC(Word operand);
+    template<int MODE> void op_EOR(Word operand);
+    template<int MODE> void op_INC(Word operand);
+    template<int MODE> void op_JMP(Word operand);
+    template<int MODE> void op_LDA(Word operand);
+    template<int MODE> void op_LDX(Word operand);
+    template<int MODE> void op_LDY(Word operand);
+    template<int MODE> void op_LSR(Word operand);
+    template<int MODE> void op_ORA(Word operand);
+    template<int MODE> void op_ROL(Word operand);
+    template<int MODE> void op_ROR(Word operand);
+    template<int MODE> void op_SBC(Word operand);
+    template<int MODE> void op_STA(Word operand);
+    template<int MODE> void op_STX(Word operand);
+    template<int MODE> void op_STY(Word operand);
+    
+    void op_BCC(Word operand);
+    void op_BCS(Word operand);
+    void op_BEQ(Word operand);
+    void op_BMI(Word operand);
+    void op_BNE(Word operand);
+    void op_BPL(Word operand);
+    void op_BRK(Word operand);
+    void op_BVC(Word operand);
+    void op_BVS(Word operand);
+    void op_CLC(Word operand);
+    void op_CLD(Word operand);
+    void op_CLI(Word operand);
+    void op_CLV(Word operand);
+    void op_DEX(Word operand);
+    void op_DEY(Word operand);
+    void op_INX(Word operand);
+    void op_INY(Word operand);
+    void op_JSR(Word operand);
+    void op_NOP(Word operand);
+    void op_PHA(Word operand);
+    void op_PHP(Word operand);
+    void op_PLA(Word operand);
+    void op_PLP(Word operand);
+    void op_RTI(Word operand);
+    void op_RTS(Word operand);
+    void op_SEC(Word operand);
+    void op_SED(Word operand);
+    void op_SEI(Word operand);
+    void op_TAX(Word operand);
+    void op_TAY(Word operand);
+    void op_TSX(Word operand);
+    void op_TXA(Word operand);
+    void op_TXS(Word operand);
+    void op_TYA(Word operand);
+    void op_invalid(Word operand);
     
     void stack_push(Byte data);
     
@@ -107,16 +301,52 @@ private:
     
     void load_opcode_data();
     
+    void load_opcodes();
+    
     void print_regs() const;
     
 public:
     CPU(Mapper &_mem);
+    ~CPU();
+    
+    // Switch to the recompiling backend. Returns false if unsupported.
+    bool enable_recompiler();
     
     void reset();
     
     long emulate(long cycles);
     
-    void set_interrupt(int i) { interrupt = i; }
+    // Interrupts are only checked at the start of emulate(). Raised from
+    // hardware touched during it, they stop the run after the current
+    // instruction instead.
+    void trigger_NMI() {
+        interrupts |= NMI_LINE;
+        stop_for_interrupt();
+    }
+    void set_IRQ_line(Byte line, bool high) {
+        if(high) {
+            interrupts |= line;
+            if(!I) stop_for_interrupt();
+        }
+        else interrupts &= ~line;
+    }
+    
+    bool is_halted() const { return halted; }
+    
+    long long get_instructions_run() const { return instructions_run; }
+    
+    // Cycles into the current call to emulate() the instruction being
+    // executed has got, for hardware that needs to know when it's touched
+    long get_elapsed_cycles() const {
+        return cycles_run - cycles_left + block_cycles + cycle_count;
+    }
+    
+    // Length of the last call to emulate(), as cut short by end_run_in()
+    long get_cycles_run() const { return cycles_run; }
+    
+    // From hardware touched during emulate(): end the run cycles from
+    // now, if it would otherwise go on longer
+    void end_run_in(long cycles);
 };
 
 #endif // CPU_H
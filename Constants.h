@@ -2,6 +2,9 @@
 #define CONSTANTS_H
 
 #include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 // Remove when this becomes unnecessary
 using namespace std;
@@ -10,8 +13,11 @@ typedef unsigned char Byte;
 typedef unsigned short Word;
 typedef bool Flag;
 
-const int ROM_SIZE                  = 0x10000;
+// 32-bit colour, 0x00RRGGBB
+typedef unsigned int Colour;
+
 const int PRG_START                 = 0x10;
+const int TRAINER_SIZE              = 0x200;
 const int PRG_BANK_SIZE             = 0x4000;
 const int CHR_BANK_SIZE             = 0x2000;
 
@@ -20,8 +26,13 @@ const int HORIZONTAL_MIRRORING      = 0;
 const int VERTICAL_MIRRORING        = 1;
 const int SINGLE_SCREEN_MIRRORING   = 2;
 const int FOUR_SCREEN_MIRRORING     = 3;
+const int SINGLE_SCREEN_UPPER_MIRRORING = 4;
 
-const int CPU_MEM_SIZE              = 0x10000;
+// 2KB of RAM at $0000, then 8KB of SRAM for $6000-$7FFF. PRG-ROM is
+// read from the ROM image.
+const int RAM_SIZE                  = 0x800;
+const int SRAM_SIZE                 = 0x2000;
+const int CPU_MEM_SIZE              = RAM_SIZE + SRAM_SIZE;
 
 enum BUTTONS {
     BUTTON_A, BUTTON_B,
@@ -19,6 +19,9 @@ inline void Controller::reset_buttons() {
 }
 
 Byte Controller::read() {
+    // Past the 8th read, a standard controller returns 1
+    if(read_index >= 8) return 1;
+    
     return buttons[read_index++];
 }
 
@@ -36,3 +39,8 @@ void Controller::set_button_state(int button, Byte state) {
     buttons[button] = state;
 }
 
+void Controller::set_buttons(Byte buttons) {
+    for(int button = BUTTON_A; button <= BUTTON_RIGHT; button++)
+        this->buttons[button] = (buttons >> button) & 1 ? PRESSED : RELEASED;
+}
+
@@ -47,6 +47,9 @@ public:
     void write(Byte value);
     
     void set_button_state(int button, Byte state);
+    
+    // Set all 8 buttons at once, a bit each, BUTTON_A in bit 0
+    void set_buttons(Byte buttons);
 };
 
 #endif // CONTROLLER_H
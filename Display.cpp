@@ -2,17 +2,93 @@
 
 Display::Display(SDL_Surface* _screen) 
     : screen(_screen), scale(1) {
+    load_palette();
 }
 
 Display::Display(SDL_Surface* _screen, int s) 
-    : screen(_screen), scale(s) {}
+    : screen(_screen), scale(s) {
+    load_palette();
+}
+
+// Map every palette colour once, rather than per pixel on every frame
+void Display::load_palette() {
+    for(int i = 0; i < 64; i++)
+        palette[i] = SDL_MapRGB(screen->format,
+            (NTSC_HEX_PALETTE[i] >> 16) & 0xFF,
+            (NTSC_HEX_PALETTE[i] >> 8) & 0xFF,
+            NTSC_HEX_PALETTE[i] & 0xFF);
+    
+    colours_match = screen->format->BytesPerPixel == 4
+        && screen->format->Rmask == 0xFF0000
+        && screen->format->Gmask == 0xFF00
+        && screen->format->Bmask == 0xFF;
+}
+
+// The screen is a 32bpp surface (see init_SDL), so each scanline is
+// converted straight into the locked pixel memory and the whole frame
+// is presented with a single flip.
+void Display::show(const Byte (*framebuffer)[256]) {
+    if(SDL_MUSTLOCK(screen) && SDL_LockSurface(screen) < 0)
+        return;
+    
+    Byte* row = (Byte*) screen->pixels;
+    
+    for(int i = 0; i < 240; i++) {
+        Uint32* pixel = (Uint32*) row;
+        
+        if(scale == 1) {
+            for(int j = 0; j < 256; j++)
+                pixel[j] = palette[framebuffer[i][j] & 0x3F];
+        }
+        else {
+            // Widen each pixel, then copy the line down for the height
+            for(int j = 0; j < 256; j++) {
+                Uint32 colour = palette[framebuffer[i][j] & 0x3F];
+                for(int s = 0; s < scale; s++) *pixel++ = colour;
+            }
+            for(int s = 1; s < scale; s++)
+                memcpy(row + s * screen->pitch, row, 256 * scale * 4);
+        }
+        
+        row += scale * screen->pitch;
+    }
+    
+    if(SDL_MUSTLOCK(screen)) SDL_UnlockSurface(screen);
+    
+    SDL_Flip(screen);
+}
 
-void Display::show(const Byte (*framebuffer)[256]) {        
+// Colours from the PPU are already what the screen wants, usually, so
+// each scanline is a copy
+void Display::show(const Colour (*framebuffer)[256]) {
+    if(SDL_MUSTLOCK(screen) && SDL_LockSurface(screen) < 0)
+        return;
+    
+    Byte* row = (Byte*) screen->pixels;
+    
     for(int i = 0; i < 240; i++) {
-        for(int j = 0; j < 256; j++) {
-            SDL_Rect pixel = {j * scale, i * scale, scale, scale };
-            SDL_FillRect(screen, &pixel, NTSC_HEX_PALETTE[framebuffer[i][j]]);
+        Uint32* pixel = (Uint32*) row;
+        
+        if(scale == 1 && colours_match)
+            memcpy(pixel, framebuffer[i], 256 * 4);
+        else {
+            for(int j = 0; j < 256; j++) {
+                Uint32 colour = framebuffer[i][j];
+                
+                if(!colours_match)
+                    colour = SDL_MapRGB(screen->format, (colour >> 16) & 0xFF,
+                        (colour >> 8) & 0xFF, colour & 0xFF);
+                
+                for(int s = 0; s < scale; s++) *pixel++ = colour;
+            }
+            for(int s = 1; s < scale; s++)
+                memcpy(row + s * screen->pitch, row, 256 * scale * 4);
         }
+        
+        row += scale * screen->pitch;
     }
+    
+    if(SDL_MUSTLOCK(screen)) SDL_UnlockSurface(screen);
+    
     SDL_Flip(screen);
 }
@@ -3,16 +3,27 @@
 
 #include "SDL.h"
 #include "Constants.h"
+#include "VideoSink.h"
 
-class Display {
+class Display : public VideoSink {
     SDL_Surface* screen;
     int scale;
     
+    // NTSC_HEX_PALETTE mapped to the screen's 32-bit pixel format
+    Uint32 palette[64];
+    
+    // Whether the screen's pixels are 0x00RRGGBB, so colours can be
+    // copied straight in
+    bool colours_match;
+    
+    void load_palette();
+    
 public:
     Display(SDL_Surface* _screen);
     Display(SDL_Surface* _screen, int s);
     
     void show(const Byte (*framebuffer)[256]);
+    void show(const Colour (*framebuffer)[256]);
 };
 
 #endif // DISPLAY_H
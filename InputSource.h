@@ -0,0 +1,17 @@
+// Where controller input comes from, polled once per frame. SDLInput reads
+// the keyboard and joystick; headless runs can script it or pass none.
+
+#ifndef INPUT_SOURCE_H
+#define INPUT_SOURCE_H
+
+#include "Controller.h"
+
+class InputSource {
+public:
+    virtual ~InputSource() {}
+    
+    // Update the controllers. Returns false to stop emulation.
+    virtual bool poll(Controller &controller_1, Controller &controller_2) = 0;
+};
+
+#endif // INPUT_SOURCE_H
@@ -0,0 +1,79 @@
+#include "MMC1.h"
+
+MMC1::MMC1(const ROM &rom, Memory &mem, PPU &ppu, Controller &controller_1)
+    : Mapper(rom, mem, ppu, controller_1) {
+}
+
+void MMC1::reset() {
+    Mapper::reset();
+    
+    shift = 0;
+    shift_count = 0;
+    
+    // Last bank fixed at $C000
+    control = 0x0C;
+    CHR_bank_0 = 0;
+    CHR_bank_1 = 1;
+    PRG_bank = 0;
+    
+    map_banks();
+}
+
+void MMC1::write_register(Byte data, Word address) {
+    // Reset the shift register, and go back to the last bank at $C000
+    if(data & 0x80) {
+        shift = 0;
+        shift_count = 0;
+        control |= 0x0C;
+        map_banks();
+        return;
+    }
+    
+    shift |= (data & 1) << shift_count;
+    if(++shift_count < 5) return;
+    
+    switch((address >> 13) & 3) {
+        case 0: control = shift; break;
+        case 1: CHR_bank_0 = shift; break;
+        case 2: CHR_bank_1 = shift; break;
+        case 3: PRG_bank = shift & 0x0F; break;
+    }
+    
+    shift = 0;
+    shift_count = 0;
+    
+    map_banks();
+}
+
+void MMC1::map_banks() {
+    static const Byte mirroring_modes[] = {
+        SINGLE_SCREEN_MIRRORING, SINGLE_SCREEN_UPPER_MIRRORING,
+        VERTICAL_MIRRORING, HORIZONTAL_MIRRORING
+    };
+    
+    set_mirroring(mirroring_modes[control & 3]);
+    
+    switch((control >> 2) & 3) {
+        case 0:
+        case 1:
+            map_PRG_16K(0, PRG_bank & ~1);
+            map_PRG_16K(1, PRG_bank | 1);
+            break;
+            
+        case 2:
+            map_PRG_16K(0, 0);
+            map_PRG_16K(1, PRG_bank);
+            break;
+            
+        case 3:
+            map_PRG_16K(0, PRG_bank);
+            map_PRG_16K(1, rom.get_num_PRG_banks() - 1);
+            break;
+    }
+    
+    if(control & 0x10) {
+        map_CHR_4K(0, CHR_bank_0);
+        map_CHR_4K(1, CHR_bank_1);
+    }
+    else map_CHR_8K(CHR_bank_0 >> 1);
+}
@@ -0,0 +1,50 @@
+// MMC1 (mapper 1)
+//
+// Registers are loaded a bit at a time. Each write to $8000-$FFFF shifts
+// bit 0 in, and the fifth write goes to the register picked by bits 13
+// and 14 of its address. A write with bit 7 set clears the shift register
+// instead.
+//
+//   +---------------+------------------------------------------------+
+//   | $8000 - $9FFF | Control: %CPPMM                                |
+//   |               |   MM: 0 = single screen, lower nametable       |
+//   |               |       1 = single screen, upper nametable       |
+//   |               |       2 = vertical, 3 = horizontal             |
+//   |               |   PP: 0, 1 = 32KB PRG at $8000                 |
+//   |               |       2 = first bank at $8000, switch $C000    |
+//   |               |       3 = switch $8000, last bank at $C000     |
+//   |               |    C: 0 = 8KB CHR, 1 = two 4KB banks           |
+//   | $A000 - $BFFF | CHR bank 0, for $0000                          |
+//   | $C000 - $DFFF | CHR bank 1, for $1000 (4KB mode only)          |
+//   | $E000 - $FFFF | PRG bank (bits 0-3)                            |
+//   +---------------+------------------------------------------------+
+//
+// CHR bank numbers are in 4KB units, even in 8KB mode, where bit 0 is
+// ignored. The 512KB boards that use CHR bank bits as PRG bits aren't
+// supported.
+
+#ifndef MMC1_H
+#define MMC1_H
+
+#include "Constants.h"
+#include "Mapper.h"
+
+class MMC1 : public Mapper {
+    Byte shift;
+    int shift_count;
+    
+    Byte control;
+    Byte CHR_bank_0;
+    Byte CHR_bank_1;
+    Byte PRG_bank;
+    
+    void map_banks();
+    void write_register(Byte data, Word address);
+    
+public:
+    MMC1(const ROM &rom, Memory &mem, PPU &ppu, Controller &controller_1);
+    
+    void reset();
+};
+
+#endif // MMC1_H
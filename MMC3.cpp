@@ -0,0 +1,107 @@
+#include "MMC3.h"
+
+MMC3::MMC3(const ROM &rom, Memory &mem, PPU &ppu, Controller &controller_1)
+    : Mapper(rom, mem, ppu, controller_1) {
+}
+
+void MMC3::reset() {
+    Mapper::reset();
+    
+    static const Byte power_on_banks[] = { 0, 2, 4, 5, 6, 7, 0, 1 };
+    
+    bank_select = 0;
+    memcpy(banks, power_on_banks, sizeof(banks));
+    
+    IRQ_latch = 0;
+    IRQ_counter = 0;
+    IRQ_reload = false;
+    IRQ_enabled = false;
+    
+    map_banks();
+}
+
+void MMC3::write_register(Byte data, Word address) {
+    switch(address & 0xE001) {
+        case 0x8000:
+            bank_select = data;
+            map_banks();
+            break;
+            
+        case 0x8001:
+            banks[bank_select & 7] = data;
+            map_banks();
+            break;
+            
+        // Four screen boards have their own nametable RAM
+        case 0xA000:
+            if(rom.get_mirroring() != FOUR_SCREEN_MIRRORING)
+                set_mirroring((data & 1) ? HORIZONTAL_MIRRORING : VERTICAL_MIRRORING);
+            break;
+            
+        case 0xC000:
+            IRQ_latch = data;
+            break;
+            
+        case 0xC001:
+            IRQ_counter = 0;
+            IRQ_reload = true;
+            break;
+            
+        case 0xE000:
+            IRQ_enabled = false;
+            IRQ = false;
+            break;
+            
+        case 0xE001:
+            IRQ_enabled = true;
+            break;
+            
+        // SRAM protect
+        default: break;
+    }
+}
+
+void MMC3::clock_scanline() {
+    if(IRQ_counter == 0 || IRQ_reload) {
+        IRQ_counter = IRQ_latch;
+        IRQ_reload = false;
+    }
+    else IRQ_counter--;
+    
+    if(IRQ_counter == 0 && IRQ_enabled) IRQ = true;
+}
+
+int MMC3::scanlines_to_IRQ() const {
+    if(!IRQ_enabled) return -1;
+    
+    // Reloaded by the next clock, then counted down to 0
+    if(IRQ_counter == 0 || IRQ_reload) return 1 + IRQ_latch;
+    
+    return IRQ_counter;
+}
+
+void MMC3::map_banks() {
+    int last = rom.get_num_PRG_banks() * 2 - 1;
+    
+    if(bank_select & 0x40) {
+        map_PRG_8K(0, last - 1);
+        map_PRG_8K(2, banks[6]);
+    }
+    else {
+        map_PRG_8K(0, banks[6]);
+        map_PRG_8K(2, last - 1);
+    }
+    
+    map_PRG_8K(1, banks[7]);
+    map_PRG_8K(3, last);
+    
+    // Pages 0 - 3 and 4 - 7 trade places
+    int swap = (bank_select & 0x80) ? 4 : 0;
+    
+    map_CHR_1K(0 ^ swap, banks[0] & 0xFE);
+    map_CHR_1K(1 ^ swap, banks[0] | 1);
+    map_CHR_1K(2 ^ swap, banks[1] & 0xFE);
+    map_CHR_1K(3 ^ swap, banks[1] | 1);
+    
+    for(int i = 0; i < 4; i++) map_CHR_1K((4 + i) ^ swap, banks[2 + i]);
+}
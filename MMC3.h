@@ -0,0 +1,65 @@
+// MMC3 (mapper 4)
+//
+// Registers are in pairs, even and odd addresses:
+//
+//   +---------------+------------------------------------------------+
+//   | $8000, even   | Bank select: %CP...RRR                         |
+//   |               |   RRR: bank register the next $8001 write sets |
+//   |               |     P: 0 = R6 at $8000, 1 = R6 at $C000, with  |
+//   |               |        the second last bank at the other       |
+//   |               |     C: 1 = swap the CHR halves                 |
+//   | $8001, odd    | Bank data, for register RRR                    |
+//   | $A000, even   | Mirroring: 0 = vertical, 1 = horizontal        |
+//   | $A001, odd    | SRAM protect                                   |
+//   | $C000 - $FFFF | Scanline IRQ                                   |
+//   +---------------+------------------------------------------------+
+//
+//   R0, R1: 2KB CHR banks at $0000 and $0800 (swapped: $1000, $1800)
+//   R2-R5:  1KB CHR banks at $1000-$1C00 (swapped: $0000-$0C00)
+//   R6, R7: 8KB PRG banks at $8000 (or $C000) and $A000
+//
+// The last PRG bank is always at $E000. Bank numbers are in 1KB and 8KB
+// units, and 2KB banks ignore bit 0. SRAM is always enabled.
+//
+//   +---------------+------------------------------------------------+
+//   | $C000, even   | IRQ latch, the count to reload the counter with|
+//   | $C001, odd    | Reload the counter on the next clock           |
+//   | $E000, even   | Disable IRQs, and acknowledge one raised       |
+//   | $E001, odd    | Enable IRQs                                    |
+//   +---------------+------------------------------------------------+
+//
+// The counter is clocked once per rendered scanline. A clock reloads it
+// if it's 0 or a reload was asked for, else counts it down. An IRQ is
+// raised whenever it's 0 after a clock. Games that fetch sprites from
+// $0000 and the background from $1000 get their clocks at the wrong
+// point of the line.
+
+#ifndef MMC3_H
+#define MMC3_H
+
+#include "Constants.h"
+#include "Mapper.h"
+
+class MMC3 : public Mapper {
+    Byte bank_select;
+    Byte banks[8];
+    
+    Byte IRQ_latch;
+    Byte IRQ_counter;
+    bool IRQ_reload;
+    bool IRQ_enabled;
+    
+    void map_banks();
+    void write_register(Byte data, Word address);
+    
+public:
+    MMC3(const ROM &rom, Memory &mem, PPU &ppu, Controller &controller_1);
+    
+    void reset();
+    
+    bool counts_scanlines() const { return true; }
+    void clock_scanline();
+    int scanlines_to_IRQ() const;
+};
+
+#endif // MMC3_H
@@ -1,7 +1,32 @@
 #include "NES.h"
+#include "Batch.h"
+#include "MovieInput.h"
+#include <vector>
+
+#ifndef NO_SDL
+#include "Display.h"
+#include "SDLInput.h"
+#endif
 
 const char* DEFAULT_ROM = "roms/Balloon Fight.nes";
 
+// Frames run by --headless without --frames
+const long DEFAULT_HEADLESS_FRAMES = 600;
+
+// Parse the number following an option, which must be at least minimum
+long option_value(const char* option, const char* value, long minimum) {
+    long number = atol(value);
+    
+    if(number < minimum) {
+        cerr << option << " needs a number of at least " << minimum << endl;
+        exit(-1);
+    }
+    
+    return number;
+}
+
+#ifndef NO_SDL
+
 SDL_Surface* screen;
 SDL_Joystick* joystick1;
 
@@ -11,8 +36,9 @@ bool init_SDL(int scale, bool fs) {
 	
     int sdl_flags = SDL_HWSURFACE | SDL_DOUBLEBUF | (fs ? SDL_FULLSCREEN : 0);
 	
+	// 32bpp so Display can write pixels straight into the surface
 	if((screen = SDL_SetVideoMode(256 * scale, 240 * scale, 
-	    24, sdl_flags)) == NULL)
+	    32, sdl_flags)) == NULL)
 		return false;
 	
 	// Hide the mouse cursor if in fullscreen mode
@@ -33,9 +59,87 @@ void clean_up() {
     SDL_Quit();
 }
 
+#endif // NO_SDL
+
 int main(int argc, char* argv[]) {
+    bool recompile = false;
+    bool threaded_ppu = false;
+    bool colour_output = false;
+    bool headless = false;
+    long frames = DEFAULT_HEADLESS_FRAMES;
+    int threads = 0;
+    int frame_skip = 0;
+    int seeds = 0;
+    const char* movie_file = 0;
+    
+    // Strip out options, leaving the positional arguments
+    int args = 0;
+    for(int i = 0; i < argc; i++) {
+        const char* option = argv[i];
+        bool has_value = i + 1 < argc;
+        
+        if(strcmp(option, "--recompile") == 0) recompile = true;
+        else if(strcmp(option, "--threaded-ppu") == 0) threaded_ppu = true;
+        else if(strcmp(option, "--rgb") == 0) colour_output = true;
+        else if(strcmp(option, "--headless") == 0) headless = true;
+        else if(strcmp(option, "--frames") == 0 && has_value)
+            frames = option_value(option, argv[++i], 1);
+        else if(strcmp(option, "--frame-skip") == 0 && has_value)
+            frame_skip = option_value(option, argv[++i], 0);
+        else if(strcmp(option, "--threads") == 0 && has_value)
+            threads = option_value(option, argv[++i], 0);
+        else if(strcmp(option, "--seeds") == 0 && has_value)
+            seeds = option_value(option, argv[++i], 1);
+        else if(strcmp(option, "--movie") == 0 && has_value)
+            movie_file = argv[++i];
+        else argv[args++] = argv[i];
+    }
+    argc = args;
+    
+    // Run without a window or input, as fast as possible, on every ROM
+    // given. One job per ROM, or per ROM and seed with --seeds.
+    if(headless) {
+        // Batch jobs already keep every core busy
+        if(threaded_ppu)
+            cerr << "--threaded-ppu is ignored with --headless" << endl;
+        if(colour_output)
+            cerr << "--rgb is ignored with --headless" << endl;
+        
+        MovieInput movie;
+        
+        if(movie_file) {
+            try {
+                movie.load_movie(movie_file);
+            }
+            catch(const char* ex) {
+                cerr << ex << endl;
+                exit(-1);
+            }
+        }
+        
+        Batch batch(frames, recompile, frame_skip, movie_file ? &movie : 0);
+        
+        vector<const char*> rom_files(argv + 1, argv + argc);
+        if(rom_files.empty()) rom_files.push_back(DEFAULT_ROM);
+        
+        for(unsigned int rom = 0; rom < rom_files.size(); rom++) {
+            if(seeds == 0) batch.add_job(rom_files[rom], 0);
+            for(int seed = 1; seed <= seeds; seed++)
+                batch.add_job(rom_files[rom], seed);
+        }
+        
+        batch.run(threads);
+        return 0;
+    }
+    
+#ifdef NO_SDL
+    cerr << "Built without SDL, only --headless is available" << endl;
+    exit(-1);
+#else
+    const char* rom_file = argc < 2 ? DEFAULT_ROM : argv[1];
     bool fs = false;
     int scale = 2;
+    
     if(argc == 3) scale = atoi(argv[2]);
     if(argc == 4) fs = true;
     
@@ -46,11 +150,24 @@ int main(int argc, char* argv[]) {
     }
     
     Display disp(screen, scale);
+    SDLInput input;
     
-    if(argc < 2) NES nes(DEFAULT_ROM, disp);
-    else NES nes(argv[1], disp);
+    try {
+        NES nes(rom_file, &disp, &input, recompile);
+        if(threaded_ppu) nes.enable_threaded_PPU();
+        if(colour_output && !nes.set_colour_output(true))
+            cerr << "--rgb isn't available with --threaded-ppu" << endl;
+        nes.set_frame_skip(frame_skip);
+        nes.run();
+    }
+    catch(const char* ex) {
+        cerr << ex << endl;
+        clean_up();
+        exit(-1);
+    }
     
     clean_up();
     
     return 0;
+#endif
 }
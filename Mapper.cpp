@@ -1,17 +1,140 @@
 #include "Mapper.h"
+#include "MMC1.h"
+#include "UxROM.h"
+#include "CNROM.h"
+#include "MMC3.h"
 
-Mapper::Mapper(Memory &_mem, PPU &_ppu, Controller &c_1) 
-    : mem(_mem), ppu(_ppu), controller_1(c_1) {}
+Mapper::Mapper(const ROM &_rom, Memory &_mem, PPU &_ppu, Controller &c_1) 
+    : mem(_mem), ppu(_ppu), controller_1(c_1), sync(0), io_written(false),
+    mirroring(0), rom(_rom), IRQ(false) {
+    map_pages();
+}
+
+Mapper* Mapper::create(const ROM &rom, Memory &mem, PPU &ppu,
+    Controller &controller_1) {
+    
+    switch(rom.get_mapper()) {
+        case 0: return new Mapper(rom, mem, ppu, controller_1);
+        case 1: return new MMC1(rom, mem, ppu, controller_1);
+        case 2: return new UxROM(rom, mem, ppu, controller_1);
+        case 3: return new CNROM(rom, mem, ppu, controller_1);
+        case 4: return new MMC3(rom, mem, ppu, controller_1);
+    }
+    
+    throw "Mapper not supported";
+}
+
+void Mapper::reset() {
+    IRQ = false;
+    
+    map_PRG_16K(0, 0);
+    map_PRG_16K(1, rom.get_num_PRG_banks() - 1);
+    
+    ppu.load_CHR_ROM(rom.get_CHR_bank(0), rom.get_num_CHR_banks());
+    
+    mirroring = rom.get_mirroring();
+    ppu.setup_mirroring(mirroring);
+}
+
+void Mapper::map_pages() {
+    for(int page = 0; page < 0x100; page++) {
+        Word address = page << 8;
+        
+        read_handlers[page] = 0;
+        write_handlers[page] = 0;
+        
+        // Memory locations 0x800, 0x1000, and 0x1800 mirror the 2KB at
+        // 0x0000 to 0x7FF
+        if(address < 0x2000) {
+            read_pages[page] = write_pages[page] = &mem[address & 0x7FF];
+        }
+        // 0x2000 to 0x3FFF mirror the 8 bytes at 0x2000 to 0x2007
+        // (PPU registers)
+        else if(address < 0x4000) {
+            read_pages[page] = write_pages[page] = 0;
+            read_handlers[page] = &Mapper::read_PPU;
+            write_handlers[page] = &Mapper::write_PPU;
+        }
+        // APU and I/O registers, then the start of expansion ROM
+        else if(address < 0x4100) {
+            read_pages[page] = write_pages[page] = 0;
+            read_handlers[page] = &Mapper::read_IO;
+            write_handlers[page] = &Mapper::write_IO;
+        }
+        // Expansion ROM, nothing here
+        else if(address < 0x6000) {
+            read_pages[page] = write_pages[page] = 0;
+            read_handlers[page] = &Mapper::read_open_bus;
+            write_handlers[page] = &Mapper::write_unmapped;
+        }
+        // SRAM, after RAM in CPU memory
+        else if(address < 0x8000) {
+            read_pages[page] = write_pages[page]
+                = &mem[RAM_SIZE + (address - 0x6000)];
+        }
+        // PRG-ROM, read only. Open bus until a bank is mapped.
+        else {
+            read_pages[page] = write_pages[page] = 0;
+            read_handlers[page] = &Mapper::read_open_bus;
+            write_handlers[page] = &Mapper::write_PRG;
+        }
+    }
+}
+
+void Mapper::set_PRG_bank(int bank, const Byte* data) {
+    for(int i = 0; i < 0x20; i++)
+        read_pages[0x80 + bank * 0x20 + i] = data + (i << 8);
+}
+
+void Mapper::map_PRG_8K(int bank, int number) {
+    set_PRG_bank(bank, rom.get_PRG_bank(number >> 1) + (number & 1) * 0x2000);
+}
 
-Byte Mapper::read(Word address) const {
-    address = translate_address(address);
+void Mapper::map_PRG_16K(int bank, int number) {
+    const Byte* data = rom.get_PRG_bank(number);
+    
+    set_PRG_bank(bank * 2, data);
+    set_PRG_bank(bank * 2 + 1, data + 0x2000);
+}
+
+void Mapper::map_CHR_1K(int page, int number) {
+    ppu.set_CHR_bank(page, number);
+}
+
+void Mapper::map_CHR_4K(int half, int number) {
+    for(int i = 0; i < 4; i++) ppu.set_CHR_bank(half * 4 + i, number * 4 + i);
+}
+
+void Mapper::map_CHR_8K(int number) {
+    for(int i = 0; i < 8; i++) ppu.set_CHR_bank(i, number * 8 + i);
+}
+
+// Changing mirroring throws away the PPU's cached lines, so only do it
+// when it really changes
+void Mapper::set_mirroring(Byte _mirroring) {
+    if(_mirroring == mirroring) return;
+    
+    mirroring = _mirroring;
+    ppu.setup_mirroring(mirroring);
+}
+
+Byte Mapper::read_PPU(Word address) {
+    address &= 0x2007;
     
     switch(address) {
         // PPU Status Register
         case 0x2002:
         // PPU VRAM Register
-        case 0x2007: return ppu.read(address);
-        
+        case 0x2007:
+            if(sync) sync->catch_up_PPU();
+            return ppu.read(address);
+    }
+    
+    return read_open_bus(address);
+}
+
+Byte Mapper::read_IO(Word address) {
+    switch(address) {
         // Controller 1
         case 0x4016: return controller_1.read();
         
@@ -19,18 +142,19 @@ Byte Mapper::read(Word address) const {
         //case 0x4017: return 0;
     }
     
-    return mem[address];
+    return read_open_bus(address);
 }
 
-Word Mapper::read_word(Word address) const {
-    address = translate_address(address);
-    Word temp = address;
-    address = translate_address(address + 1);
-    return ((Byte) read(temp) | ((Word) read(address) << 8));
+// Nothing drives the bus, so it still holds the last byte fetched. For
+// absolute addressing that's the high byte of the address.
+Byte Mapper::read_open_bus(Word address) {
+    return address >> 8;
 }
 
-void Mapper::write(Byte data, Word address) {
-    address = translate_address(address);
+void Mapper::write_PPU(Byte data, Word address) {
+    address &= 0x2007;
+    
+    io_written = true;
     
     switch(address) {
         // PPU control register 1 - write only
@@ -41,40 +165,68 @@ void Mapper::write(Byte data, Word address) {
         case 0x2003:
         // sprite memory data - read/write
         case 0x2004:
+            if(sync) sync->catch_up_PPU();
+            ppu.write(data, address);
+            // Sprite size and rendering on or off move sprite 0's hit too
+            if(sync) sync->OAM_written();
+            break;
+            
         // Background control - write only  
         case 0x2005:
         // PPU memory address - write only
         case 0x2006:
         // PPU memory data - read/write 
         case 0x2007:
+            if(sync) sync->catch_up_PPU();
             ppu.write(data, address);
             break;
-        
+    }
+}
+
+void Mapper::write_IO(Byte data, Word address) {
+    if(address < 0x4020) io_written = true;
+    
+    switch(address) {
         // DMA access to sprite memory - write only 
-        case 0x4014:
+        case 0x4014: {
             //puts("DMA write to sprite memory");
-            ppu.write_SPR_DMA(mem, data);
+            if(sync) sync->catch_up_PPU();
+            
+            const Byte* page = read_pages[data];
+            if(page) ppu.write_SPR_DMA(page);
+            else {
+                // Registers - go through the handlers
+                Byte buffer[0x100];
+                for(int i = 0; i < 0x100; i++) buffer[i] = read((data << 8) | i);
+                ppu.write_SPR_DMA(buffer);
+            }
+            
+            if(sync) sync->OAM_written();
             break;
+        }
             
         // Joypad reset address
         case 0x4016:
             controller_1.write(data);
             break;
-            
-        default:
-            mem[address] = data;
     }
 }
 
-void Mapper::write(const Byte* data, Word address, int length) {
-    for(int i = 0; i < length; i++) write(data[i], address++);
+// PRG-ROM is read only. Writes here are for the mapper, which may
+// switch CHR banks or mirroring, so scanlines already passed are drawn
+// first.
+void Mapper::write_PRG(Byte data, Word address) {
+    io_written = true;
+    
+    if(sync) sync->catch_up_PPU();
+    write_register(data, address);
+    if(sync) sync->mapper_written();
 }
 
-// Memory locations 0x800, 0x1000, and 0x1800 mirror the 2MB at 0x0000 to 0x7FF
-// 0x2000 to 0x3FFF mirror the 7 bytes at 0x2000 to 0x2007 (PPU registers)
-inline Word Mapper::translate_address(Word address) const {    
-    if(address < 0x2000) return address & 0x7FF;
-    else if(address < 0x4000) return address & 0x2007;
+void Mapper::write_unmapped(Byte data, Word address) {
     
-    return address;
+}
+
+void Mapper::write(const Byte* data, Word address, int length) {
+    for(int i = 0; i < length; i++) write(data[i], address++);
 }
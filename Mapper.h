@@ -10,7 +10,7 @@
 //   | $2000   | 8     |       | Registers             |
 //   | $2008   | $1FF8 |  R    | Registers             |
 //   | $4000   | $20   |       | Registers             |
-//   | $4020   | $1FDF |       | Expansion ROM         |
+//   | $4020   | $1FDF |  U    | Expansion ROM         |
 //   | $6000   | $2000 |       | SRAM                  |
 //   | $8000   | $4000 |       | PRG-ROM               |
 //   | $C000   | $4000 |       | PRG-ROM               |
@@ -18,13 +18,25 @@
 //          Flag Legend: M = Mirror of $0000
 //                       R = Mirror of $2000-2008 every 8 bytes
 //                           (e.g. $2008=$2000, $2018=$2000, etc.)
+//                       U = Unmapped, reads are open bus
+//
+//  Only RAM and SRAM are held in CPU memory, RAM first. PRG-ROM is
+//  read in place from the ROM image, through a pointer per 8KB bank.
+//
+//  Mapper is the CPU's memory map, and is also the cartridge with no
+//  mapper hardware (NROM, mapper 0). Cartridges with bank switching are
+//  subclasses, made by create(). They only see writes to $8000-$FFFF,
+//  through write_register(), and switch banks by moving pointers. Reads
+//  never leave the page tables, so they cost the same on any cartridge.
 
 #ifndef MAPPER_H
 #define MAPPER_H
 
 #include "Constants.h"
 #include "Memory.h"
+#include "ROM.h"
 #include "PPU.h"
+#include "PPUSync.h"
 #include "Controller.h"
 
 class Mapper {
@@ -33,15 +45,111 @@ private:
     PPU &ppu;
     Controller &controller_1;
     
-    Word translate_address(Word address) const;
+    // Told before the PPU is accessed, may be 0
+    PPUSync* sync;
+    
+    // Set by writes to the registers at $2000-$401F and to the mapper
+    // ($8000-$FFFF)
+    bool io_written;
+    
+    // Register access, for pages that aren't plain memory
+    typedef Byte (Mapper::*ReadHandler)(Word address);
+    typedef void (Mapper::*WriteHandler)(Byte data, Word address);
+    
+    // Page tables, one entry per 256 bytes of the CPU address space. Each
+    // page is either host memory (with mirrors already resolved) or 0, in
+    // which case the page's handler is called.
+    const Byte* read_pages[0x100];
+    Byte* write_pages[0x100];
+    ReadHandler read_handlers[0x100];
+    WriteHandler write_handlers[0x100];
+    
+    // As last set up in the PPU
+    Byte mirroring;
+    
+    void map_pages();
+    
+    Byte read_PPU(Word address);
+    Byte read_IO(Word address);
+    Byte read_open_bus(Word address);
+    void write_PPU(Byte data, Word address);
+    void write_IO(Byte data, Word address);
+    void write_PRG(Byte data, Word address);
+    void write_unmapped(Byte data, Word address);
+    
+    // Map the 8KB at data to $8000 + bank * $2000. Only the pointers
+    // change, nothing is copied.
+    void set_PRG_bank(int bank, const Byte* data);
+    
+protected:
+    const ROM &rom;
+    
+    // Bank switching, by bank number. Numbers wrap at the size of the
+    // ROM, so they needn't be masked.
+    void map_PRG_8K(int bank, int number);
+    void map_PRG_16K(int bank, int number);
+    void map_CHR_1K(int page, int number);
+    void map_CHR_4K(int half, int number);
+    void map_CHR_8K(int number);
+    void set_mirroring(Byte _mirroring);
+    
+    // A write to $8000-$FFFF. The PPU has been caught up already, so
+    // banks can be switched under it.
+    virtual void write_register(Byte data, Word address) {}
+    
+    // Set while the cartridge pulls the CPU's IRQ line low
+    bool IRQ;
     
 public:
-    Mapper(Memory &_mem, PPU &_ppu, Controller &controller_1);
+    Mapper(const ROM &_rom, Memory &_mem, PPU &_ppu, Controller &controller_1);
+    virtual ~Mapper() {}
     
-    Byte read(Word address) const;
-    Word read_word(Word address) const;
+    // The mapper the ROM asks for. Throws a message if it isn't supported.
+    static Mapper* create(const ROM &rom, Memory &mem, PPU &ppu,
+        Controller &controller_1);
+    
+    // Power on state: the first 16KB of PRG-ROM at $8000 and the last at
+    // $C000, the first 8KB of CHR, and the ROM's mirroring
+    virtual void reset();
+    
+    void set_PPU_sync(PPUSync* _sync) { sync = _sync; }
+    
+    // Scanline counters (MMC3) are clocked once per rendered scanline,
+    // when the PPU moves from background to sprite fetches (dot 260).
+    virtual bool counts_scanlines() const { return false; }
+    virtual void clock_scanline() {}
+    
+    // Clocks until the counter next raises an IRQ, or -1 if it won't
+    virtual int scanlines_to_IRQ() const { return -1; }
+    
+    bool IRQ_raised() const { return IRQ; }
+    
+    Byte read(Word address);
+    Word read_word(Word address);
     void write(Byte data, Word address);
     void write(const Byte* data, Word address, int length); 
+    
+    // 8KB PRG bank currently mapped at $8000 + bank * $2000
+    const Byte* get_PRG_bank(int bank) const { return read_pages[0x80 + bank * 0x20]; }
+    
+    const bool* get_io_write_flag() const { return &io_written; }
+    void clear_io_write_flag() { io_written = false; }
 };
 
+inline Byte Mapper::read(Word address) {
+    const Byte* page = read_pages[address >> 8];
+    if(page) return page[address & 0xFF];
+    return (this->*read_handlers[address >> 8])(address);
+}
+
+inline Word Mapper::read_word(Word address) {
+    return read(address) | ((Word) read(address + 1) << 8);
+}
+
+inline void Mapper::write(Byte data, Word address) {
+    Byte* page = write_pages[address >> 8];
+    if(page) page[address & 0xFF] = data;
+    else (this->*write_handlers[address >> 8])(data, address);
+}
+
 #endif // MAPPER_H
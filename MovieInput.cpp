@@ -0,0 +1,37 @@
+#include "MovieInput.h"
+#include <fstream>
+#include <string>
+
+MovieInput::MovieInput() :
+    frame(0) {
+}
+
+void MovieInput::load_movie(const char* file) {
+    ifstream in(file);
+    
+    if(!in) throw "Couldn't load movie";
+    
+    frames.clear();
+    frame = 0;
+    
+    string line;
+    
+    while(getline(in, line)) {
+        if(line.empty() || line[0] == '#') continue;
+        
+        if(line.size() < 8) throw "Movie lines need 8 buttons";
+        
+        Byte buttons = 0;
+        for(int button = BUTTON_A; button <= BUTTON_RIGHT; button++)
+            if(line[button] != '.') buttons |= 1 << button;
+        
+        frames.push_back(buttons);
+    }
+}
+
+bool MovieInput::poll(Controller &controller_1, Controller &controller_2) {
+    controller_1.set_buttons(frame < frames.size() ? frames[frame] : 0);
+    frame++;
+    
+    return true;
+}
@@ -0,0 +1,35 @@
+// Button presses played back from a movie file. Each line of the file is
+// one frame, giving the state of the 8 buttons in the order
+//
+//   A B SELECT START UP DOWN LEFT RIGHT
+//
+// with '.' for released and any other character for pressed, e.g.
+// "A......R" holds A and right. Lines starting with '#' are comments.
+// Once the movie runs out, all buttons are released.
+
+#ifndef MOVIE_INPUT_H
+#define MOVIE_INPUT_H
+
+#include "Constants.h"
+#include "InputSource.h"
+#include <vector>
+
+class MovieInput : public InputSource {
+    // Bit per button for each frame, BUTTON_A first
+    std::vector<Byte> frames;
+    
+    unsigned int frame;
+    
+public:
+    MovieInput();
+    
+    // Throws a message if the file can't be read
+    void load_movie(const char* file);
+    
+    // Start playback from the first frame again
+    void rewind() { frame = 0; }
+    
+    bool poll(Controller &controller_1, Controller &controller_2);
+};
+
+#endif // MOVIE_INPUT_H
@@ -1,156 +1,347 @@
 #include "NES.h"
 
-NES::NES(const char* rom_file, Display &display) :
-    rom(),
+NES::NES(const char* rom_file, VideoSink* video, InputSource* input,
+    bool recompile) :
+    rom(rom_file),
     cpu_mem(CPU_MEM_SIZE),
     ppu(), 
-    mapper(cpu_mem, ppu, controller_1),
-    cpu(mapper),
+    mapper(Mapper::create(rom, cpu_mem, ppu, controller_1)),
+    cpu(*mapper),
     controller_1(),
-    display(display) {
+    video(video),
+    input(input),
+    cpu_time(0),
+    frame_start(0),
+    frame(0),
+    next_scanline(0),
+    next_clock(0),
+    ppu_thread(0),
+    drawn_frame(0),
+    frame_skip(0),
+    thread_drew(false) {
     
-    try {
-        rom.load_ROM(rom_file);
-    }
-    catch(const char* ex) {
-        cerr << ex << endl;
-        exit(-1);
-    }
+    mapper->set_PPU_sync(this);
+    
+    if(recompile && !cpu.enable_recompiler())
+        cerr << "Recompiler not supported, using interpreter" << endl;
     
-    ppu.setup_mirroring(rom.get_mirroring());
+    reset();
+}
+
+NES::~NES() {
+    delete ppu_thread;
+    delete mapper;
+}
+
+bool NES::set_colour_output(bool on) {
+    if(ppu_thread) return false;
     
-    // fill ram with PRG bank(s)
-    cpu_mem.fast_write(rom.get_PRG_bank_1(), 0x8000, PRG_BANK_SIZE);
-    // some games only have 1 16k PRG bank, so the banks should be mirrored
+    ppu.set_colour_output(on);
+    return true;
+}
+
+void NES::enable_threaded_PPU() {
+    if(ppu_thread) return;
     
-    if(rom.get_num_PRG_banks() == 1)
-        cpu_mem.fast_write(rom.get_PRG_bank_1(), 0xC000, PRG_BANK_SIZE);
-        
-    // otherwise write the second PRG bank
-    else
-        cpu_mem.fast_write(rom.get_PRG_bank_2(), 0xC000, PRG_BANK_SIZE);
-    // fill PPU ram with CHRROM
+    ppu_thread = new PPUThread;
+    ppu.set_replay(ppu_thread);
+    drawn_frame = ppu.get_framebuffer();
     
-    if(rom.get_num_CHR_banks() > 0)
-        ppu.load_CHR_bank(rom.get_CHR_bank());
-        
-    run();
+    // Brings the thread's PPU up to here
+    reset();
 }
 
-void NES::run() {
-    cpu.reset();
+void NES::reset() {
     ppu.reset();
     
-    // Actually 113.66666666666667
-    const int cpu_cycles_per_scanline = 113; // make into a global const
+    // Banks first, the CPU reads the reset vector through them
+    mapper->reset();
+    cpu.reset();
+    
+    cpu_time = 0;
+    frame_start = 0;
+    frame = 0;
+    next_scanline = 0;
+    next_clock = 0;
+    
+    scheduler.clear();
+    scheduler.schedule(frame_start + 241 * TICKS_PER_SCANLINE
+        + TICKS_PER_PPU_DOT, EVENT_VBLANK_START);
+}
+
+void NES::run() {
+    while(step_frame());
+}
+
+bool NES::run(long frames) {
+    for(long i = 0; i < frames; i++)
+        if(!step_frame()) return false;
+    
+    return true;
+}
+
+bool NES::step_frame() {
+    if(cpu.is_halted()) return false;
+    
+    if(input && !input->poll(controller_1, controller_2))
+        return false;
+    
+    bool draw = frame % (frame_skip + 1) == frame_skip;
+    ppu.set_drawing(draw);
+    
+    scheduler.schedule(frame_start + TICKS_PER_FRAME, EVENT_FRAME_END);
+    
+    while(true) {
+        run_CPU(scheduler.next().time);
+        
+        // The mapper may have brought in an earlier event while the CPU
+        // ran, and stopped it there
+        Scheduler::Event event = scheduler.pop();
+        
+        if(event.type == EVENT_FRAME_END) break;
+        
+        handle_event(event);
+    }
     
-    // Tracks cycles used/remaining
-    long cpu_cycles_remaining = 0;
+    clock_mapper_to(frame_start + TICKS_PER_FRAME);
     
-    SDL_Event event;
+    frame_start += TICKS_PER_FRAME;
+    next_scanline = 0;
+    next_clock = 0;
     
-    // Main emulation loop
-    for(long frame = 0; ; frame++) {
+    if(ppu_thread) {
+        const Byte (*framebuffer)[256] = ppu_thread->end_frame();
         
-        while(SDL_PollEvent(&event)) {
-            if(event.type == SDL_QUIT || event.key.keysym.sym == SDLK_ESCAPE)
-                return;
-                
-            else if(event.type == SDL_KEYDOWN)
-                handle_key_input(event.key.keysym.sym, PRESSED);
-            else if(event.type == SDL_KEYUP)
-                handle_key_input(event.key.keysym.sym, RELEASED);
-                
-            if(event.type == SDL_JOYBUTTONDOWN
-                || event.type == SDL_JOYBUTTONUP
-                || event.type == SDL_JOYAXISMOTION)
-                
-                handle_joy_input(event);
+        if(framebuffer) {
+            drawn_frame = framebuffer;
+            if(video && thread_drew) video->show(drawn_frame);
         }
         
-        for(int scanline = 0; scanline < 262; scanline++) {
-            
-            if(ppu.VBlank_occurring()) cpu.set_interrupt(NMI);
+        thread_drew = draw;
+    }
+    else if(video && draw) {
+        if(ppu.get_colour_framebuffer()) video->show(ppu.get_colour_framebuffer());
+        else video->show(ppu.get_framebuffer());
+    }
+    
+    frame++;
+    
+    return true;
+}
 
-            cpu_cycles_remaining = cpu.emulate(cpu_cycles_per_scanline
-            + cpu_cycles_remaining
-            // This accounts for the remainder cycles - but needs checking
-            + ((frame * scanline) % 3 == 0 ? 2 : 0));
+// Run the CPU until it reaches the deadline. It finishes the instruction
+// it is on, so may go a few cycles past.
+void NES::run_CPU(Ticks deadline) {
+    long cycles = (deadline - cpu_time + TICKS_PER_CPU_CYCLE - 1)
+        / TICKS_PER_CPU_CYCLE;
+    
+    if(cycles <= 0) return;
+    
+    // emulate() returns how far short of, or past, the budget it ended.
+    // The budget may have been cut short.
+    long left = cpu.emulate(cycles);
+    cpu_time += (cpu.get_cycles_run() - left) * TICKS_PER_CPU_CYCLE;
+}
 
-            ppu.emulate();
-        }
-        
-        display.show(ppu.get_framebuffer());
+// Scanline N is drawn once its last dot has passed, as if it were done
+// all at once at the end of the line
+void NES::render_to(Ticks time) {
+    while(next_scanline < 240
+        && frame_start + (next_scanline + 1) * TICKS_PER_SCANLINE <= time)
+        ppu.render_scanline(next_scanline++);
+}
+
+// From the mapper, before the CPU touches the PPU
+void NES::catch_up_PPU() {
+    Ticks now = cpu_time + cpu.get_elapsed_cycles() * TICKS_PER_CPU_CYCLE;
+    
+    render_to(now);
+    clock_mapper_to(now);
+}
+
+// Clock 0 - 239 is at the end of a visible line, clock 240 the pre-render
+// line
+Ticks NES::scanline_clock_time(int clock) const {
+    int line = clock < 240 ? clock : 261;
+    
+    return frame_start + line * TICKS_PER_SCANLINE
+        + SCANLINE_CLOCK_DOT * TICKS_PER_PPU_DOT;
+}
+
+// Give the mapper the scanline clocks that have passed. Lines are only
+// counted while rendering is on, which can only change through the PPU's
+// registers. They catch this up first, so it has been the same since
+// the last call.
+void NES::clock_mapper_to(Ticks time) {
+    if(!mapper->counts_scanlines()) return;
+    
+    while(next_clock < SCANLINE_CLOCKS && scanline_clock_time(next_clock) <= time) {
+        if(ppu.rendering_enabled()) mapper->clock_scanline();
+        next_clock++;
     }
 }
 
-void NES::handle_key_input(int key, int state) {
-    switch(key) {
-        case SDLK_s:        controller_1.set_button_state(BUTTON_A, state); break;
-        case SDLK_a:        controller_1.set_button_state(BUTTON_B, state); break;
-        case SDLK_RETURN:   controller_1.set_button_state(BUTTON_START, state); break;
-        case SDLK_TAB:      controller_1.set_button_state(BUTTON_SELECT, state); break;
-        case SDLK_UP:       controller_1.set_button_state(BUTTON_UP, state); break;
-        case SDLK_DOWN:     controller_1.set_button_state(BUTTON_DOWN, state); break;
-        case SDLK_LEFT:     controller_1.set_button_state(BUTTON_LEFT, state); break;
-        case SDLK_RIGHT:    controller_1.set_button_state(BUTTON_RIGHT, state); break;
+// Stop at the clock that will raise the mapper's IRQ, counting as if
+// rendering stays on. If it's turned off, fewer clocks will have
+// passed by then, and the deadline is just moved on.
+void NES::schedule_mapper_IRQ() {
+    scheduler.cancel(EVENT_MAPPER_IRQ);
+    
+    int clocks = mapper->scanlines_to_IRQ();
+    if(clocks < 0) return;
+    
+    int clock = next_clock + clocks - 1;
+    
+    scheduler.schedule(scanline_clock_time(clock % SCANLINE_CLOCKS)
+        + (clock / SCANLINE_CLOCKS) * TICKS_PER_FRAME, EVENT_MAPPER_IRQ);
+}
+
+// From the mapper, after the CPU wrote to it. An IRQ may have been
+// acknowledged, or the counter set up for one, maybe before the CPU
+// was going to stop.
+void NES::mapper_written() {
+    if(!mapper->counts_scanlines()) return;
+    
+    cpu.set_IRQ_line(MAPPER_IRQ_LINE, mapper->IRQ_raised());
+    
+    schedule_mapper_IRQ();
+    end_CPU_run_at_next_event();
+}
+
+// An event placed during the CPU's run may come before the deadline it
+// was given. Stop the run there instead, so it isn't missed.
+void NES::end_CPU_run_at_next_event() {
+    Ticks now = cpu_time + cpu.get_elapsed_cycles() * TICKS_PER_CPU_CYCLE;
+    
+    cpu.end_run_in((scheduler.next().time - now + TICKS_PER_CPU_CYCLE - 1)
+        / TICKS_PER_CPU_CYCLE);
+}
+
+// Games poll for sprite 0 hit without touching the PPU otherwise, and
+// an idle loop can skip right to the next event. So stop at the end of
+// the first scanline of the next frame a hit could happen on.
+void NES::schedule_sprite_0() {
+    scheduler.cancel(EVENT_SPRITE_0);
+    
+    int line = ppu.get_sprite_0_line();
+    
+    if(line < 240)
+        scheduler.schedule(frame_start + TICKS_PER_FRAME
+            + (line + 1) * TICKS_PER_SCANLINE, EVENT_SPRITE_0, line);
+}
+
+// From the mapper, after the CPU wrote to sprite memory, or changed the
+// sprite size or rendering through $2000 or $2001. While the frame is
+// being drawn, place this frame's sprite 0 event again, from the first
+// line of the sprite not yet passed. Once VBlank is over, place the next
+// frame's again. During VBlank, the end of it will.
+void NES::OAM_written() {
+    Ticks now = cpu_time + cpu.get_elapsed_cycles() * TICKS_PER_CPU_CYCLE;
+    int scanline = (now - frame_start) / TICKS_PER_SCANLINE;
+    
+    if(scanline >= 240) {
+        if(now >= frame_start + 261 * TICKS_PER_SCANLINE + TICKS_PER_PPU_DOT)
+            schedule_sprite_0();
+        return;
+    }
+    
+    scheduler.cancel(EVENT_SPRITE_0);
+    
+    if(ppu.sprite_0_hit()) return;
+    
+    int top = ppu.get_sprite_0_line();
+    int line = top > scanline ? top : scanline;
+    
+    if(line < 240 && line < top + ppu.get_sprite_height()) {
+        scheduler.schedule(frame_start + (line + 1) * TICKS_PER_SCANLINE,
+            EVENT_SPRITE_0, line);
+        end_CPU_run_at_next_event();
     }
 }
 
-void NES::handle_joy_input(const SDL_Event &event) {
+void NES::handle_event(const Scheduler::Event &event) {
     switch(event.type) {
-        case SDL_JOYAXISMOTION: {
-            switch(event.jaxis.axis) {
-                case 0: {
-                    if(event.jaxis.value < -32000)
-                        controller_1.set_button_state(BUTTON_LEFT, PRESSED);
-                    else if(event.jaxis.value > 32000)
-                        controller_1.set_button_state(BUTTON_RIGHT, PRESSED);
-                    else {
-                        controller_1.set_button_state(BUTTON_LEFT, RELEASED);
-                        controller_1.set_button_state(BUTTON_RIGHT, RELEASED);
-                    }
-                    break;
-                }
-                case 1: {
-                    if(event.jaxis.value < -32000)
-                        controller_1.set_button_state(BUTTON_UP, PRESSED);
-                    else if(event.jaxis.value > 32000)
-                        controller_1.set_button_state(BUTTON_DOWN, PRESSED);
-                    else {
-                        controller_1.set_button_state(BUTTON_UP, RELEASED);
-                        controller_1.set_button_state(BUTTON_DOWN, RELEASED);
-                    }
-                    break;
-                }
-            }
+        case EVENT_SPRITE_0: {
+            render_to(event.time);
+            
+            // Missed, try the sprite's next scanline
+            int line = event.data + 1;
+            
+            if(!ppu.sprite_0_hit() && line < 240
+                && line < ppu.get_sprite_0_line() + ppu.get_sprite_height())
+                scheduler.schedule(event.time + TICKS_PER_SCANLINE,
+                    EVENT_SPRITE_0, line);
+            break;
+        }
+        case EVENT_VBLANK_START: {
+            render_to(event.time);
+            
+            ppu.start_VBlank();
+            
+            scheduler.schedule(frame_start + 261 * TICKS_PER_SCANLINE
+                + TICKS_PER_PPU_DOT, EVENT_VBLANK_END);
+            
+            if(ppu.VBlank_occurring()) cpu.trigger_NMI();
+            
+            // With NMI off, check again each scanline in case it's
+            // switched on before VBlank is over
+            else scheduler.schedule(event.time + TICKS_PER_SCANLINE,
+                EVENT_NMI_POLL);
+            break;
+        }
+        case EVENT_NMI_POLL: {
+            if(ppu.VBlank_occurring()) cpu.trigger_NMI();
+            
+            else if(event.time + TICKS_PER_SCANLINE
+                < frame_start + 261 * TICKS_PER_SCANLINE)
+                scheduler.schedule(event.time + TICKS_PER_SCANLINE,
+                    EVENT_NMI_POLL);
             break;
         }
-        case SDL_JOYBUTTONDOWN: {
-            switch(event.jbutton.button) {
-                case 0: controller_1.set_button_state(BUTTON_B, PRESSED); break;
-                case 1: controller_1.set_button_state(BUTTON_A, PRESSED); break;
-                case 2: controller_1.set_button_state(BUTTON_SELECT, PRESSED); break;
-                case 3: controller_1.set_button_state(BUTTON_START, PRESSED); break;
-            }
+        case EVENT_VBLANK_END: {
+            ppu.end_VBlank();
+            
+            scheduler.schedule(frame_start + TICKS_PER_FRAME
+                + 241 * TICKS_PER_SCANLINE + TICKS_PER_PPU_DOT,
+                EVENT_VBLANK_START);
+            
+            schedule_sprite_0();
             break;
         }
-        case SDL_JOYBUTTONUP: {
-            switch(event.jbutton.button) {
-                case 0: controller_1.set_button_state(BUTTON_B, RELEASED); break;
-                case 1: controller_1.set_button_state(BUTTON_A, RELEASED); break;
-                case 2: controller_1.set_button_state(BUTTON_SELECT, RELEASED); break;
-                case 3: controller_1.set_button_state(BUTTON_START, RELEASED); break;
-            }
+        case EVENT_MAPPER_IRQ: {
+            clock_mapper_to(event.time);
+            cpu.set_IRQ_line(MAPPER_IRQ_LINE, mapper->IRQ_raised());
+            
+            schedule_mapper_IRQ();
             break;
         }
     }
 }
 
+// 64-bit FNV-1a over the palette indices, or colour bytes
+unsigned long long NES::get_frame_hash() const {
+    const Byte* pixels = (const Byte*) get_framebuffer();
+    int size = 240 * 256;
+    
+    if(get_colour_framebuffer()) {
+        pixels = (const Byte*) get_colour_framebuffer();
+        size *= sizeof(Colour);
+    }
+    
+    unsigned long long hash = 0xCBF29CE484222325ULL;
+    
+    for(int i = 0; i < size; i++) {
+        hash ^= pixels[i];
+        hash *= 0x100000001B3ULL;
+    }
+    
+    return hash;
+}
+
 void NES::print_ascii() {
     for(int i = 0; i < 240; i++) {
         for(int j = 0; j < 256; j++) {
-            printf("%d", ppu.get_framebuffer()[i][j]);
+            printf("%d", get_framebuffer()[i][j]);
         }
         puts("");
     }
@@ -1,40 +1,135 @@
 #ifndef NES_H
 #define NES_H
 
-// For events
-#include "SDL.h"
-
 #include "Constants.h"
 #include "CPU.h"
 #include "PPU.h"
 #include "Memory.h"
 #include "Mapper.h"
 #include "ROM.h"
-#include "Display.h"
 #include "Controller.h"
+#include "Scheduler.h"
+#include "PPUSync.h"
+#include "PPUThread.h"
+#include "VideoSink.h"
+#include "InputSource.h"
 
 const int NTSC_FPS = 60;
 
-class NES {
+// The emulated console. Knows nothing of SDL: frames go to a VideoSink and
+// controller input comes from an InputSource, either of which may be null.
+class NES : private PPUSync {
     ROM rom;
     Memory cpu_mem;
     PPU ppu;
-    Mapper mapper;
+    Mapper* mapper;
     CPU cpu;
     
     Controller controller_1, controller_2;
     
-    Display& display;
+    VideoSink* video;
+    InputSource* input;
+    
+    Scheduler scheduler;
+    
+    // Master clock time the CPU has run up to, and when this frame started
+    Ticks cpu_time;
+    Ticks frame_start;
+    
+    long frame;
+    
+    // Next visible scanline the PPU has to draw, 240 once all are done
+    int next_scanline;
+    
+    // Next of this frame's scanline counter clocks to give the mapper,
+    // SCANLINE_CLOCKS once all are done
+    int next_clock;
+    
+    // Draws for the PPU when threaded, else 0
+    PPUThread* ppu_thread;
+    
+    // Last frame the thread finished
+    const Byte (*drawn_frame)[256];
+    
+    // Frames not drawn between each one drawn
+    int frame_skip;
+    
+    // Whether the thread's last frame was drawn, or skipped
+    bool thread_drew;
+    
+    void run_CPU(Ticks deadline);
+    
+    // Draw the visible scanlines that have finished by time
+    void render_to(Ticks time);
+    void catch_up_PPU();
+    
+    Ticks scanline_clock_time(int clock) const;
+    void clock_mapper_to(Ticks time);
+    void schedule_mapper_IRQ();
+    void mapper_written();
+    
+    void end_CPU_run_at_next_event();
     
-    void handle_key_input(int key, int state);
-    void handle_joy_input(const SDL_Event &event);
+    void schedule_sprite_0();
+    void OAM_written();
+    
+    void handle_event(const Scheduler::Event &event);
     
     void print_ascii();
     
 public:
-    NES(const char* rom_file, Display &display);
+    // Throws a message if the ROM can't be loaded
+    NES(const char* rom_file, VideoSink* video, InputSource* input,
+        bool recompile);
+    ~NES();
+    
+    // Draw on another thread, a frame behind the CPU. Resets the NES.
+    void enable_threaded_PPU();
+    
+    // Press the reset button. RAM is left as it was.
+    void reset();
+    
+    // Set controller 1's buttons, a bit each, BUTTON_A in bit 0. Only
+    // needed without an input source.
+    void set_buttons(Byte buttons) { controller_1.set_buttons(buttons); }
+    
+    bool is_halted() const { return cpu.is_halted(); }
+    
+    // Only draw one frame in every skip + 1. The others still run the
+    // PPU, but only as far as sprite 0 hit and the status register go,
+    // and aren't shown. The framebuffer keeps the last frame drawn.
+    void set_frame_skip(int skip) { frame_skip = skip; }
+    
+    // Have the PPU draw 32-bit colours rather than palette indices, so
+    // frames go to the video sink ready to display. Not available with
+    // the threaded PPU, returns false if so.
+    bool set_colour_output(bool on);
     
+    // Run until the input source says to stop
     void run();
+    
+    // Run for a number of frames. Returns false if stopped early.
+    bool run(long frames);
+    
+    // Emulate one frame. Returns false if the input source says to stop,
+    // or the CPU has halted.
+    bool step_frame();
+    
+    long get_frame_count() const { return frame; }
+    long long get_instruction_count() const { return cpu.get_instructions_run(); }
+    
+    const Byte (*(get_framebuffer)() const)[256] {
+        return ppu_thread ? drawn_frame : ppu.get_framebuffer();
+    }
+    
+    // Only with colour output on, else 0
+    const Colour (*(get_colour_framebuffer)() const)[256] {
+        return ppu.get_colour_framebuffer();
+    }
+    
+    // Hash of the current frame, for comparing runs. Of the colours, with
+    // colour output on.
+    unsigned long long get_frame_hash() const;
 };
 
 #endif // NES_H
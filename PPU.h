@@ -29,6 +29,7 @@
 
 #include "Constants.h"
 #include "Memory.h"
+#include "Render.h"
 
 const int VRAM_SIZE = 0x4000;
 const int SPR_RAM_SIZE = 0x100;
@@ -36,6 +37,14 @@ const int SPR_RAM_SIZE = 0x100;
 const int SPRITE_8x8 = 0;
 const int SPRITE_8x16 = 1;
 
+// Most sprites the PPU can show on one scanline
+const int MAX_LINE_SPRITES = 8;
+
+// sprite_flags bits, per pixel of the sprite line
+const Byte SPRITE_PIXEL     = 0x01;     // a sprite is opaque here
+const Byte SPRITE_BEHIND    = 0x02;     // ...and is behind the background
+const Byte SPRITE_0_PIXEL   = 0x04;     // ...and is sprite 0
+
 const int PATTERN_TABLE_0 = 0x0000;
 const int PATTERN_TABLE_1 = 0x1000;
 
@@ -50,15 +59,20 @@ const int ATTRIBUTE_TABLE_SIZE = 0x40;
 const int IMAGE_PALETTE = 0x3F00;
 const int SPRITE_PALETTE = 0x3F10;
 
-const int MAX_SCANLINE = 262;
+// 256 tiles in each pattern table
+const int NUM_TILES = 512;
+
+// The pattern tables are switched in 1KB pages of 64 tiles
+const int CHR_PAGE_SIZE = 0x400;
+const int CHR_PAGE_TILES = 64;
+
+// Rows in a nametable, including the two taken by the attribute table
+const int NAMETABLE_ROWS = 32;
+
+class PPUThread;
 
 class PPU {
 private:
-    // Table storing attribute byte lookup information
-    Byte attribute_byte_table[960];
-    // Table to storing attribute square lookup
-    Byte attribute_square_table[960];
-    
     // Main PPU memory
     Memory VRAM;
     
@@ -85,20 +99,48 @@ private:
     // Determines nametable address increment - 1 (horiz.) or 32 (vert.)
     Byte address_increment;
     
+    // The scroll registers, shared by $2000, $2005 and $2006. While
+    // rendering, the access address (v) is the position being drawn:
+    //
+    //   yyy NN YYYYY XXXXX
+    //   |   |  |     +------ coarse X scroll (tile column)
+    //   |   |  +------------ coarse Y scroll (tile row)
+    //   |   +--------------- nametable
+    //   +------------------- fine Y scroll (row within the tile)
+    //
+    // The temp address (t) is laid out the same and is copied into v at
+    // the start of each line and frame. Fine X scroll (x) is separate.
     Word VRAM_access_address;
+    Word VRAM_temp_address;
+    Byte fine_x_scroll;
+    
+    // v and x as they were at the start of the current scanline
+    Word line_address;
+    Byte line_fine_x;
     
     // Pattern tables
     Byte* background_pattern_table;
     Byte* sprite_pattern_table;
     
-    // Nametables (used for background)
-    Byte* nametable_0;
-    Byte* nametable_1;
-    Byte* nametable_2;
-    Byte* nametable_3;
+    // CHR-RAM decoded, kept up to date with VRAM writes
+    TileRow tile_rows[NUM_TILES][8];
+    
+    // CHR-ROM, 0 if the cartridge has CHR-RAM, and all of it decoded
+    const Byte* CHR_ROM;
+    int CHR_ROM_pages;
+    TileRow (*CHR_ROM_tile_rows)[8];
+    
+    // The 8 1KB pages of the pattern tables, in CHR-ROM or CHR-RAM, and
+    // their decoded tiles. Switching a bank just moves these.
+    const Byte* pattern_pages[8];
+    const TileRow (*tile_pages[8])[8];
     
-    // Nametable currently in use. Set via bits 0 and 1 of control reg 1
-    Byte* current_nametable;
+    // The pattern tables' first tiles in tile_rows
+    int background_tiles;
+    int sprite_tiles;
+    
+    // Nametables (used for background), with mirroring resolved
+    Byte* nametables[4];
     
     // Determines background visibiliy
     bool render_background;
@@ -110,22 +152,86 @@ private:
     
     // comment required here...
     bool first_read;
+    // The write toggle (w) shared by $2005 and $2006
     bool first_write;
     
     // Current scanline
     int scanline_count;
     
-    // Nametable table row index for current tile
-    int nametable_index;
-    
-    // Vertical offset of current tile
-    int v_tile_offset;
-    
     // temp - for testing, maybe unnecessary
     Byte framebuffer[240][256];
     
+    // Drawn to instead of framebuffer when colour output is on, else 0
+    Colour (*colour_framebuffer)[256];
+    
+    // The palette as drawn with: mirroring resolved, so colour 0 of every
+    // background palette is the backdrop, and greyscale applied. Then the
+    // same through the emphasis palette picked by $2001. Rebuilt before
+    // drawing if the palette or $2001 has changed.
+    Byte palette_values[32];
+    Colour palette_colours[32];
+    bool palette_changed;
+    
+    // Whether scanlines are drawn into the framebuffer. If not, only as
+    // much is done as the status register needs: sprite overflow, and
+    // sprite 0 hit on the scanlines sprite 0 is on.
+    bool drawing;
+    
+    // Gets a copy of everything done to this PPU, to draw it elsewhere
+    PPUThread* replay;
+    
+    // Background palette indices of the current scanline, 0 where clear.
+    // Points into background_lines, or at blank_line when the background
+    // is off.
+    TileRow* background_line;
+    
+    // Each scanline's background as last fetched. One tile more than the
+    // screen, so it can be shifted by fine X.
+    TileRow background_lines[240][33];
+    TileRow blank_line[33];
+    
+    // What each of background_lines was fetched from. A line is fetched
+    // again only if its scroll position or pattern table has changed, or
+    // VRAM it uses has been written since.
+    struct CachedLine {
+        Word address;
+        Byte fine_x;
+        int tiles;
+        unsigned long long stamp;   // 0 if never fetched
+    };
+    
+    CachedLine cached_lines[240];
+    
+    // Counts VRAM writes. Each nametable row and pattern table records
+    // the count when it was last written, and each cached line the count
+    // when it was fetched. 64 bits, so the count can't wrap round to
+    // below the stamps of lines already cached.
+    unsigned long long VRAM_stamp;
+    unsigned long long nametable_row_stamps[4][NAMETABLE_ROWS];
+    unsigned long long pattern_table_stamps[2];
+    
+    // Sprites found on the current scanline, 4 OAM bytes each, in OAM
+    // order, and whether the first is sprite 0
+    Byte secondary_OAM[MAX_LINE_SPRITES * 4];
+    int line_sprites;
+    bool sprite_0_on_line;
+    
+    // Sprite pixels of the current scanline, before merging, as
+    // palette entries (16 - 31)
+    Byte sprite_line[256];
+    Byte sprite_flags[256];
+    
+    void update_palette();
+    
+    void fetch_background_line();
     void render_background_scanline();
-    void render_sprite_frame();
+    TileRow fetch_sprite_row(const Byte* sprite, int height);
+    void test_sprite_0();
+    bool background_line_cached(const CachedLine &line, Word address);
+    void stamp_VRAM_write(Word address);
+    void clear_line_cache();
+    void evaluate_sprites();
+    void render_sprite_scanline();
     
     void write_PPU_Control_Reg_1(Byte data);
     void write_PPU_Control_Reg_2(Byte data);
@@ -137,27 +243,66 @@ private:
     Byte read_VRAM();
     void write_VRAM(Byte data);
     
-    void set_current_nametable();
+    Byte& VRAM_byte(Word address);
+    
+    void increment_fine_y();
+    void start_line();
     
-    void load_attribute_byte_table();
-    void load_attribute_square_table();
+    void decode_tile_row(Word address);
+    const TileRow& tile_row(int tile, int row) const;
     
 public:
     PPU();
+    ~PPU();
     
     const Byte (*(get_framebuffer)() const)[256] { return framebuffer; }
     
+    // Draw 32-bit colours, with colour emphasis, instead of palette
+    // indices. The colour framebuffer is 0 until this is turned on.
+    void set_colour_output(bool on);
+    const Colour (*(get_colour_framebuffer)() const)[256] { return colour_framebuffer; }
+    
     void reset();
     void setup_mirroring(Byte mirroring);
     
+    // Stop drawing, and send everything to the thread instead, which
+    // keeps its own PPU in step to draw with. Before reset().
+    void set_replay(PPUThread* thread);
+    
+    // Whether to draw scanlines from now on. The framebuffer keeps the
+    // last picture drawn.
+    void set_drawing(bool draw);
+    
     Byte read(Word address);
     void write(Byte data, Word address);
-    void write_SPR_DMA(Memory &cpumem, Byte address);
+    void write_SPR_DMA(const Byte* page);
+    
+    // Scanline events, see Scheduler.h
+    void render_scanline(int scanline);
+    void start_VBlank();
+    void end_VBlank();
+    
+    bool rendering_enabled() const { return render_background || render_sprites; }
+    
+    // Where sprite 0 is, so a hit can be waited for
+    bool sprite_0_hit() const { return PPU_Status_Reg & 0x40; }
+    int get_sprite_0_line() { return SPR_RAM[0] + 1; }
+    int get_sprite_height() const { return sprite_size == SPRITE_8x16 ? 16 : 8; }
     
-    void emulate();
     bool VBlank_occurring();
     
-    void load_CHR_bank(const Byte *chr);
+    // Use banks 8KB banks of CHR-ROM, decoding them all, or CHR-RAM if
+    // banks is 0. The first 8KB is mapped in.
+    void load_CHR_ROM(const Byte* chr, int banks);
+    
+    // Map 1KB bank number bank to page (0 - 7) of the pattern tables.
+    // Banks wrap at the size of CHR-ROM, or the 8KB of CHR-RAM.
+    void set_CHR_bank(int page, int bank);
 };
 
+// Row of a tile (0 - 511) in the pattern tables as currently mapped
+inline const TileRow& PPU::tile_row(int tile, int row) const {
+    return tile_pages[tile / CHR_PAGE_TILES][tile % CHR_PAGE_TILES][row];
+}
+
 #endif // PPU_H
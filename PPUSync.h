@@ -0,0 +1,25 @@
+// The PPU only draws when something needs to see what it has drawn. The
+// mapper calls this before the CPU touches the PPU, so the scanlines
+// before that moment are drawn with the PPU state they really had.
+// Scanline counters on the cartridge are brought up to date the same way.
+
+#ifndef PPU_SYNC_H
+#define PPU_SYNC_H
+
+class PPUSync {
+public:
+    virtual ~PPUSync() {}
+    
+    // Draw every scanline that has finished by now
+    virtual void catch_up_PPU() = 0;
+    
+    // After a write to the mapper's registers, which may have changed
+    // its IRQ
+    virtual void mapper_written() = 0;
+    
+    // After a write to sprite memory, $2000 or $2001, which may have
+    // moved where sprite 0 hits
+    virtual void OAM_written() = 0;
+};
+
+#endif // PPU_SYNC_H
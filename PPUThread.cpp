@@ -0,0 +1,99 @@
+#include "PPUThread.h"
+
+PPUThread::PPUThread() :
+    head(0),
+    tail(0),
+    frames_sent(0),
+    frames_done(0) {
+    
+    thread = std::thread(&PPUThread::run, this);
+}
+
+PPUThread::~PPUThread() {
+    push(PPU_STOP);
+    thread.join();
+}
+
+void PPUThread::push(Byte type, Word address, Byte data, const Byte* bank) {
+    unsigned int position = head.load(std::memory_order_relaxed);
+    
+    // Full, wait for the thread to catch up
+    while(position - tail.load(std::memory_order_acquire) == PPU_RING_SIZE)
+        std::this_thread::yield();
+    
+    Command &command = ring[position & (PPU_RING_SIZE - 1)];
+    command.type = type;
+    command.data = data;
+    command.address = address;
+    command.bank = bank;
+    
+    head.store(position + 1, std::memory_order_release);
+}
+
+const Byte (*PPUThread::end_frame())[256] {
+    push(PPU_FRAME_END);
+    frames_sent++;
+    
+    if(frames_sent < 2) return 0;
+    
+    // Let the thread stay up to a frame behind
+    while(frames_done.load(std::memory_order_acquire) < frames_sent - 1)
+        std::this_thread::yield();
+    
+    return frames[frames_sent & 1];
+}
+
+void PPUThread::run() {
+    // Spin for a while on an empty ring before sleeping, commands tend to
+    // come in bursts
+    int idle = 0;
+    
+    while(true) {
+        unsigned int position = tail.load(std::memory_order_relaxed);
+        
+        if(position == head.load(std::memory_order_acquire)) {
+            if(++idle < 1000) std::this_thread::yield();
+            else std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continue;
+        }
+        
+        idle = 0;
+        
+        const Command &command = ring[position & (PPU_RING_SIZE - 1)];
+        
+        if(command.type == PPU_STOP) return;
+        
+        execute(command);
+        
+        tail.store(position + 1, std::memory_order_release);
+    }
+}
+
+void PPUThread::execute(const Command &command) {
+    switch(command.type) {
+        case PPU_RESET: ppu.reset(); break;
+        case PPU_MIRRORING: ppu.setup_mirroring(command.data); break;
+        case PPU_CHR_ROM: ppu.load_CHR_ROM(command.bank, command.address); break;
+        case PPU_CHR_BANK: ppu.set_CHR_bank(command.data, command.address); break;
+        case PPU_READ: ppu.read(command.address); break;
+        case PPU_WRITE: ppu.write(command.data, command.address); break;
+        
+        case PPU_DMA: {
+            DMA_page[command.address] = command.data;
+            if(command.address == 0xFF) ppu.write_SPR_DMA(DMA_page);
+            break;
+        }
+        
+        case PPU_SCANLINE: ppu.render_scanline(command.address); break;
+        case PPU_VBLANK_START: ppu.start_VBlank(); break;
+        case PPU_VBLANK_END: ppu.end_VBlank(); break;
+        case PPU_DRAWING: ppu.set_drawing(command.data); break;
+        
+        case PPU_FRAME_END: {
+            long frame = frames_done.load(std::memory_order_relaxed);
+            memcpy(frames[frame & 1], ppu.get_framebuffer(), sizeof(frames[0]));
+            frames_done.store(frame + 1, std::memory_order_release);
+            break;
+        }
+    }
+}
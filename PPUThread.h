@@ -0,0 +1,87 @@
+// Threaded PPU
+//
+// Draws the picture on a thread of its own, so the CPU can get on with
+// the next frame while this one is drawn. The PPU the CPU talks to stops
+// drawing and hands a copy of everything done to it - register reads and
+// writes, sprite DMA, scanlines and VBlank - to this thread through a
+// lock-free single producer, single consumer ring. The thread does the
+// same to a PPU of its own, which draws.
+//
+// Status reads don't wait on the thread. The CPU's PPU still keeps all
+// the state, and finds sprite overflow and sprite 0 hit itself without
+// drawing anything. Commands are replayed in order, scanlines included,
+// so they need no timestamps.
+
+#ifndef PPU_THREAD_H
+#define PPU_THREAD_H
+
+#include "Constants.h"
+#include "PPU.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Command types
+enum {
+    PPU_RESET,
+    PPU_MIRRORING,          // data is the mirroring type
+    PPU_CHR_ROM,            // bank is the CHR-ROM to load, address its size
+    PPU_CHR_BANK,           // address is the bank to map at page data
+    PPU_READ,               // at address
+    PPU_WRITE,              // data to address
+    PPU_DMA,                // data to sprite memory at address
+    PPU_SCANLINE,           // address is the scanline
+    PPU_VBLANK_START,
+    PPU_VBLANK_END,
+    PPU_DRAWING,            // data is whether to draw
+    PPU_FRAME_END,
+    PPU_STOP
+};
+
+// Commands the ring can hold. A frame usually takes a few hundred.
+const int PPU_RING_SIZE = 0x10000;
+
+class PPUThread {
+    struct Command {
+        Byte type;
+        Byte data;
+        Word address;
+        const Byte* bank;
+    };
+    
+    PPU ppu;
+    
+    Command ring[PPU_RING_SIZE];
+    
+    // Written only by the CPU's thread and this one respectively
+    std::atomic<unsigned int> head;
+    std::atomic<unsigned int> tail;
+    
+    // Finished frames, alternately
+    Byte frames[2][240][256];
+    
+    // Frames handed over, and finished
+    long frames_sent;
+    std::atomic<long> frames_done;
+    
+    // Sprite memory as it arrives from DMA
+    Byte DMA_page[0x100];
+    
+    std::thread thread;
+    
+    void run();
+    void execute(const Command &command);
+    
+public:
+    PPUThread();
+    ~PPUThread();
+    
+    // From the CPU's thread. Waits if the ring is full.
+    void push(Byte type, Word address = 0, Byte data = 0, const Byte* bank = 0);
+    
+    // End the CPU's frame. Returns the frame before it once it's drawn,
+    // or 0 if this is the first.
+    const Byte (*end_frame())[256];
+};
+
+#endif // PPU_THREAD_H
@@ -1,36 +1,70 @@
 #include "ROM.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+ROM::~ROM() {
+    if(image) munmap((void*) image, length);
+}
 
 void ROM::load_ROM(const char* file) {
-    // Open ROM file for reading
-    ifstream in_file(file, ios::in | ios::binary);
+    int fd = open(file, O_RDONLY);
+    if(fd < 0) throw "Couldn't load ROM";
     
-    length = 0;
-    // Load ROM into array
-    while(in_file.good()) rom[length++] = in_file.get();
-    in_file.close();
-
-    if(length == 0) throw "Couldn't load ROM";
+    struct stat info;
+    if(fstat(fd, &info) < 0 || info.st_size < PRG_START) {
+        close(fd);
+        throw "Not a valid iNES ROM image";
+    }
+    
+    // Map the whole file. The mapping stays valid once fd is closed.
+    void* mapping = mmap(0, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    
+    if(mapping == MAP_FAILED) throw "Couldn't load ROM";
+    
+    const Byte* rom = (const Byte*) mapping;
+    
+    // Check the image before taking it on. A trainer comes before the
+    // first PRG bank.
+    int PRG_offset = PRG_START + ((rom[6] & 4) ? TRAINER_SIZE : 0);
+    int CHR_offset = PRG_offset + PRG_BANK_SIZE * rom[4];
+    
+    const char* error = 0;
     
     Byte identifier[] = { 'N', 'E', 'S', 0x1A };
-
+    
     for(int i = 0; i < 4; i++)
-        if(rom[i] != identifier[i]) throw "Not a valid iNES ROM image";
+        if(rom[i] != identifier[i]) error = "Not a valid iNES ROM image";
     
-    num_PRG_banks = rom[4];
-    num_CHR_banks = rom[5];
+    if(!error && rom[4] == 0) error = "ROM has no PRG-ROM";
+    
+    if(!error && CHR_offset + CHR_BANK_SIZE * rom[5] > info.st_size)
+        error = "ROM image is truncated";
     
-    PRG_bank_1 = &rom[PRG_START];
+    if(error) {
+        munmap(mapping, info.st_size);
+        throw error;
+    }
     
-    if(num_PRG_banks > 1) PRG_bank_2 = &rom[PRG_START + PRG_BANK_SIZE];
+    if(image) munmap((void*) image, length);
+    
+    image = rom;
+    length = info.st_size;
+    
+    num_PRG_banks = rom[4];
+    num_CHR_banks = rom[5];
     
-    CHR_bank = &rom[PRG_START + (PRG_BANK_SIZE * (num_PRG_banks == 1 ? 1: 2))];
+    PRG = &rom[PRG_offset];
+    CHR = &rom[CHR_offset];
     
-    // needs testing - SINGLE SCREEN AND FOUR SCREEN NOT REGISTERING
-    mirroring = (rom[6] & 1) | (rom[6] & 8);
+    // needs testing - SINGLE SCREEN NOT REGISTERING
+    mirroring = (rom[6] & 8) ? FOUR_SCREEN_MIRRORING : (rom[6] & 1);
     
-    // needs testing
-    mapper = ((rom[6] >> 4) & 0xF) | (rom[7] & 0xF0);
+    // Old dumps can have junk in bytes 7 - 15 (like "DiskDude!"), in
+    // which case the high bits of the mapper number can't be trusted
+    mapper = (rom[6] >> 4) & 0xF;
     
-    //if(mapper != 0)
-    //  throw "Only ROMs using mapper 0 (no mapper) supported at this time";
+    if(!rom[12] && !rom[13] && !rom[14] && !rom[15]) mapper |= rom[7] & 0xF0;
 }
@@ -31,16 +31,17 @@
 #define ROM_H
 
 #include "Constants.h"
-#include <fstream>
 
+// The image is mapped read only rather than read in, so loading costs
+// next to nothing and instances running the same game share its pages.
+// PRG and CHR banks are views into the mapping.
 class ROM {
 private:
-    Byte rom[ROM_SIZE];
+    const Byte* image;
     unsigned int length;
     
-    Byte* PRG_bank_1;
-    Byte* PRG_bank_2;
-    Byte* CHR_bank;
+    const Byte* PRG;
+    const Byte* CHR;
     
     Byte num_PRG_banks;
     Byte num_CHR_banks;
@@ -50,20 +51,35 @@ private:
     Byte mirroring;
     
 public:
-    ROM() {};
+    ROM() : image(0), length(0), PRG(0), CHR(0), num_PRG_banks(0),
+        num_CHR_banks(0), mapper(0), mirroring(0) {};
+    ROM(const char* file) : ROM() { load_ROM(file); }
+    ~ROM();
     
-    void load_ROM(const char* file);
+    // Owns the mapping, so can't be copied
+    ROM(const ROM&) = delete;
+    ROM& operator=(const ROM&) = delete;
     
-    Byte* get_PRG_bank_1() const { return PRG_bank_1; }
+    // Throws a message if the file isn't a valid image, leaving any ROM
+    // already loaded in place
+    void load_ROM(const char* file);
     
-    Byte* get_PRG_bank_2() const { return PRG_bank_2; }
+    // 16K PRG banks, numbered from 0 and wrapping at the bank count
+    const Byte* get_PRG_bank(int bank) const {
+        return PRG + (bank % num_PRG_banks) * PRG_BANK_SIZE;
+    }
     
-    Byte* get_CHR_bank() const { return CHR_bank; }
+    // 8K CHR banks, 0 if the cartridge has CHR-RAM
+    const Byte* get_CHR_bank(int bank) const {
+        return num_CHR_banks ? CHR + (bank % num_CHR_banks) * CHR_BANK_SIZE : 0;
+    }
     
     Byte get_num_PRG_banks() const { return num_PRG_banks; }
     
     Byte get_num_CHR_banks() const { return num_CHR_banks; }
     
+    Byte get_mapper() const { return mapper; }
+    
     Byte get_mirroring() const { return mirroring; }
 };
 
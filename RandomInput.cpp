@@ -0,0 +1,22 @@
+#include "RandomInput.h"
+
+RandomInput::RandomInput(unsigned int seed) :
+    state(seed),
+    buttons(0) {
+}
+
+// Plain LCG, good enough for mashing buttons
+inline unsigned int RandomInput::next_random() {
+    state = state * 1103515245 + 12345;
+    return (state >> 16) & 0x7FFF;
+}
+
+bool RandomInput::poll(Controller &controller_1, Controller &controller_2) {
+    // 1 in 16 chance of a change
+    for(int button = BUTTON_A; button <= BUTTON_RIGHT; button++)
+        if((next_random() & 0xF) == 0) buttons ^= 1 << button;
+    
+    controller_1.set_buttons(buttons);
+    
+    return true;
+}
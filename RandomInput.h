@@ -0,0 +1,25 @@
+// Button presses made up from a seed, the same every time for the same
+// seed. Each frame, every button has a small chance of changing state, so
+// presses are held for a while the way a player would.
+
+#ifndef RANDOM_INPUT_H
+#define RANDOM_INPUT_H
+
+#include "Constants.h"
+#include "InputSource.h"
+
+class RandomInput : public InputSource {
+    unsigned int state;
+    
+    // Bit per button, BUTTON_A first
+    Byte buttons;
+    
+    unsigned int next_random();
+    
+public:
+    RandomInput(unsigned int seed);
+    
+    bool poll(Controller &controller_1, Controller &controller_2);
+};
+
+#endif // RANDOM_INPUT_H
@@ -0,0 +1,156 @@
+#include "Render.h"
+
+// Emphasis darkens the other two channels. How much varies between TVs,
+// this is about what the usual palette generators use.
+struct EmphasisPalettes {
+    Colour colours[8][64];
+    
+    EmphasisPalettes() {
+        for(int emphasis = 0; emphasis < 8; emphasis++) {
+            for(int i = 0; i < 64; i++) {
+                Colour colour = 0;
+                
+                // Red, green, blue: bits 0, 1 and 2 of emphasis
+                for(int channel = 0; channel < 3; channel++) {
+                    double value = (NTSC_HEX_PALETTE[i] >> (16 - channel * 8)) & 0xFF;
+                    
+                    for(int bit = 0; bit < 3; bit++)
+                        if(bit != channel && ((emphasis >> bit) & 1)) value *= 0.816;
+                    
+                    colour |= (Colour) (value + 0.5) << (16 - channel * 8);
+                }
+                
+                colours[emphasis][i] = colour;
+            }
+        }
+    }
+};
+
+const Colour* emphasis_palette(int emphasis) {
+    static const EmphasisPalettes palettes;
+    return palettes.colours[emphasis & 7];
+}
+
+static void resolve_scalar(const TileRow* rows, int count,
+    const Byte* palette, Byte* out) {
+    
+    for(int i = 0; i < count; i++)
+        for(int k = 0; k < 8; k++)
+            *out++ = palette[(rows[i] >> (k << 3)) & 0x0F];
+}
+
+static void resolve_scalar_colours(const TileRow* rows, int count,
+    const Colour* palette, Colour* out) {
+    
+    for(int i = 0; i < count; i++)
+        for(int k = 0; k < 8; k++)
+            *out++ = palette[(rows[i] >> (k << 3)) & 0x0F];
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+#include <immintrin.h>
+
+// pshufb is a 16 entry table lookup, 16 pixels (2 rows) at a time
+__attribute__((target("ssse3")))
+static void resolve_ssse3(const TileRow* rows, int count,
+    const Byte* palette, Byte* out) {
+    
+    __m128i colours = _mm_loadu_si128((const __m128i*) palette);
+    
+    for(int i = 0; i < count; i += 2) {
+        __m128i indices = _mm_loadu_si128((const __m128i*) (rows + i));
+        _mm_storeu_si128((__m128i*) (out + (i << 3)),
+            _mm_shuffle_epi8(colours, indices));
+    }
+}
+
+// The same, 32 pixels (4 rows) at a time. vpshufb looks up within each
+// 128-bit lane, so the palette goes in both.
+__attribute__((target("avx2")))
+static void resolve_avx2(const TileRow* rows, int count,
+    const Byte* palette, Byte* out) {
+    
+    __m256i colours = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*) palette));
+    
+    for(int i = 0; i < count; i += 4) {
+        __m256i indices = _mm256_loadu_si256((const __m256i*) (rows + i));
+        _mm256_storeu_si256((__m256i*) (out + (i << 3)),
+            _mm256_shuffle_epi8(colours, indices));
+    }
+}
+
+// To colours, a row (8 pixels) at a time. vpermd is an 8 entry table
+// lookup, so look up in both halves of the palette and pick by bit 3.
+__attribute__((target("avx2")))
+static void resolve_avx2_colours(const TileRow* rows, int count,
+    const Colour* palette, Colour* out) {
+    
+    __m256i low = _mm256_loadu_si256((const __m256i*) palette);
+    __m256i high = _mm256_loadu_si256((const __m256i*) (palette + 8));
+    __m256i bit_3 = _mm256_set1_epi32(8);
+    
+    for(int i = 0; i < count; i++) {
+        __m256i indices = _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64((const __m128i*) (rows + i)));
+        
+        __m256i in_high = _mm256_cmpeq_epi32(
+            _mm256_and_si256(indices, bit_3), bit_3);
+        
+        _mm256_storeu_si256((__m256i*) (out + (i << 3)),
+            _mm256_blendv_epi8(
+                _mm256_permutevar8x32_epi32(low, indices),
+                _mm256_permutevar8x32_epi32(high, indices), in_high));
+    }
+}
+
+typedef void (*Resolver)(const TileRow*, int, const Byte*, Byte*);
+typedef void (*ColourResolver)(const TileRow*, int, const Colour*, Colour*);
+
+static Resolver pick_resolver() {
+    __builtin_cpu_init();
+    
+    if(__builtin_cpu_supports("avx2")) return resolve_avx2;
+    if(__builtin_cpu_supports("ssse3")) return resolve_ssse3;
+    
+    return resolve_scalar;
+}
+
+static ColourResolver pick_colour_resolver() {
+    __builtin_cpu_init();
+    
+    if(__builtin_cpu_supports("avx2")) return resolve_avx2_colours;
+    
+    return resolve_scalar_colours;
+}
+
+void resolve_tile_rows(const TileRow* rows, int count, const Byte* palette,
+    Byte* out) {
+    
+    static const Resolver resolve = pick_resolver();
+    resolve(rows, count, palette, out);
+}
+
+void resolve_tile_rows(const TileRow* rows, int count, const Colour* palette,
+    Colour* out) {
+    
+    static const ColourResolver resolve = pick_colour_resolver();
+    resolve(rows, count, palette, out);
+}
+
+#else
+
+void resolve_tile_rows(const TileRow* rows, int count, const Byte* palette,
+    Byte* out) {
+    
+    resolve_scalar(rows, count, palette, out);
+}
+
+void resolve_tile_rows(const TileRow* rows, int count, const Colour* palette,
+    Colour* out) {
+    
+    resolve_scalar_colours(rows, count, palette, out);
+}
+
+#endif
@@ -0,0 +1,50 @@
+// Pixel kernels for the PPU
+//
+// Tiles are kept decoded as TileRows: 8 2-bit colour indices, a byte
+// each, leftmost pixel in the low byte. With the attribute palette ORed
+// into each byte, a row holds 8 indices into the 16 entry background
+// palette, so a whole scanline can be resolved to colours with byte
+// shuffles. On x86 the widest of AVX2, SSSE3 or plain C++ the host
+// supports is picked at run time.
+//
+// Lines can also be resolved straight to 32-bit colours, for output
+// that's ready for the display.
+
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "Constants.h"
+
+typedef unsigned long long TileRow;
+
+// Each byte of a TileRow set to value
+const TileRow TILE_ROW_BYTES = 0x0101010101010101ULL;
+
+// Spread the 8 bits of a bitplane byte over the bytes of a TileRow,
+// bit 7 (the leftmost pixel) into the low byte, without a loop: copy the
+// byte into every byte, keep a different bit in each, then turn any
+// non-zero byte into 1 by adding 0x7F and taking bit 7.
+inline TileRow expand_bitplane(Byte plane) {
+    TileRow bits = (plane * TILE_ROW_BYTES) & 0x0102040810204080ULL;
+    return ((bits + 0x7F * TILE_ROW_BYTES) >> 7) & TILE_ROW_BYTES;
+}
+
+// Colour indices (0-3) of one row of a tile from its two bitplanes
+inline TileRow expand_bitplanes(Byte plane_1, Byte plane_2) {
+    return expand_bitplane(plane_1) | (expand_bitplane(plane_2) << 1);
+}
+
+// Look up the count rows of palette indices (0-15) in palette, writing
+// 8 colours per row to out. count must be a multiple of 4.
+void resolve_tile_rows(const TileRow* rows, int count, const Byte* palette,
+    Byte* out);
+
+// The same, to colours
+void resolve_tile_rows(const TileRow* rows, int count, const Colour* palette,
+    Colour* out);
+
+// NTSC_HEX_PALETTE with colour emphasis applied, for each combination of
+// the emphasis bits of $2001 (D5 red, D6 green, D7 blue, shifted down)
+const Colour* emphasis_palette(int emphasis);
+
+#endif // RENDER_H
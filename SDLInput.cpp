@@ -0,0 +1,86 @@
+#include "SDLInput.h"
+
+bool SDLInput::poll(Controller &controller_1, Controller &controller_2) {
+    SDL_Event event;
+    
+    while(SDL_PollEvent(&event)) {
+        if(event.type == SDL_QUIT || event.key.keysym.sym == SDLK_ESCAPE)
+            return false;
+            
+        else if(event.type == SDL_KEYDOWN)
+            handle_key_input(controller_1, event.key.keysym.sym, PRESSED);
+        else if(event.type == SDL_KEYUP)
+            handle_key_input(controller_1, event.key.keysym.sym, RELEASED);
+            
+        if(event.type == SDL_JOYBUTTONDOWN
+            || event.type == SDL_JOYBUTTONUP
+            || event.type == SDL_JOYAXISMOTION)
+            
+            handle_joy_input(controller_1, event);
+    }
+    
+    return true;
+}
+
+void SDLInput::handle_key_input(Controller &controller, int key, int state) {
+    switch(key) {
+        case SDLK_s:        controller.set_button_state(BUTTON_A, state); break;
+        case SDLK_a:        controller.set_button_state(BUTTON_B, state); break;
+        case SDLK_RETURN:   controller.set_button_state(BUTTON_START, state); break;
+        case SDLK_TAB:      controller.set_button_state(BUTTON_SELECT, state); break;
+        case SDLK_UP:       controller.set_button_state(BUTTON_UP, state); break;
+        case SDLK_DOWN:     controller.set_button_state(BUTTON_DOWN, state); break;
+        case SDLK_LEFT:     controller.set_button_state(BUTTON_LEFT, state); break;
+        case SDLK_RIGHT:    controller.set_button_state(BUTTON_RIGHT, state); break;
+    }
+}
+
+void SDLInput::handle_joy_input(Controller &controller, const SDL_Event &event) {
+    switch(event.type) {
+        case SDL_JOYAXISMOTION: {
+            switch(event.jaxis.axis) {
+                case 0: {
+                    if(event.jaxis.value < -32000)
+                        controller.set_button_state(BUTTON_LEFT, PRESSED);
+                    else if(event.jaxis.value > 32000)
+                        controller.set_button_state(BUTTON_RIGHT, PRESSED);
+                    else {
+                        controller.set_button_state(BUTTON_LEFT, RELEASED);
+                        controller.set_button_state(BUTTON_RIGHT, RELEASED);
+                    }
+                    break;
+                }
+                case 1: {
+                    if(event.jaxis.value < -32000)
+                        controller.set_button_state(BUTTON_UP, PRESSED);
+                    else if(event.jaxis.value > 32000)
+                        controller.set_button_state(BUTTON_DOWN, PRESSED);
+                    else {
+                        controller.set_button_state(BUTTON_UP, RELEASED);
+                        controller.set_button_state(BUTTON_DOWN, RELEASED);
+                    }
+                    break;
+                }
+            }
+            break;
+        }
+        case SDL_JOYBUTTONDOWN: {
+            switch(event.jbutton.button) {
+                case 0: controller.set_button_state(BUTTON_B, PRESSED); break;
+                case 1: controller.set_button_state(BUTTON_A, PRESSED); break;
+                case 2: controller.set_button_state(BUTTON_SELECT, PRESSED); break;
+                case 3: controller.set_button_state(BUTTON_START, PRESSED); break;
+            }
+            break;
+        }
+        case SDL_JOYBUTTONUP: {
+            switch(event.jbutton.button) {
+                case 0: controller.set_button_state(BUTTON_B, RELEASED); break;
+                case 1: controller.set_button_state(BUTTON_A, RELEASED); break;
+                case 2: controller.set_button_state(BUTTON_SELECT, RELEASED); break;
+                case 3: controller.set_button_state(BUTTON_START, RELEASED); break;
+            }
+            break;
+        }
+    }
+}
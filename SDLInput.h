@@ -0,0 +1,19 @@
+// Keyboard and joystick input from SDL events. Also ends emulation when
+// the window is closed or escape is pressed.
+
+#ifndef SDL_INPUT_H
+#define SDL_INPUT_H
+
+#include "SDL.h"
+#include "Constants.h"
+#include "InputSource.h"
+
+class SDLInput : public InputSource {
+    void handle_key_input(Controller &controller, int key, int state);
+    void handle_joy_input(Controller &controller, const SDL_Event &event);
+    
+public:
+    bool poll(Controller &controller_1, Controller &controller_2);
+};
+
+#endif // SDL_INPUT_H
@@ -0,0 +1,38 @@
+#include "Scheduler.h"
+#include <algorithm>
+
+// std's heaps put the largest first, so order by later deadline
+static bool later(const Scheduler::Event &a, const Scheduler::Event &b) {
+    return a.time > b.time;
+}
+
+void Scheduler::schedule(Ticks time, int type, int data) {
+    Event event;
+    event.time = time;
+    event.type = type;
+    event.data = data;
+    
+    heap.push_back(event);
+    push_heap(heap.begin(), heap.end(), later);
+}
+
+void Scheduler::cancel(int type) {
+    unsigned int kept = 0;
+    
+    for(unsigned int i = 0; i < heap.size(); i++)
+        if(heap[i].type != type) heap[kept++] = heap[i];
+    
+    if(kept == heap.size()) return;
+    
+    heap.resize(kept);
+    make_heap(heap.begin(), heap.end(), later);
+}
+
+Scheduler::Event Scheduler::pop() {
+    pop_heap(heap.begin(), heap.end(), later);
+    
+    Event event = heap.back();
+    heap.pop_back();
+    
+    return event;
+}
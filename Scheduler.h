@@ -0,0 +1,71 @@
+// Event scheduler
+//
+// Everything is timed in master clock ticks (21.477272 MHz on NTSC). A
+// CPU cycle is 12 ticks and a PPU dot is 4, so a 341 dot scanline is
+// 1364 ticks, or 113 2/3 CPU cycles, without any rounding.
+//
+// Events are kept in a min-heap on their deadline. The CPU is run up to
+// the earliest one, the event handled, and so on. Handling an event
+// usually schedules the next of its kind, so the heap stays tiny.
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "Constants.h"
+#include <vector>
+
+typedef long long Ticks;
+
+const int TICKS_PER_CPU_CYCLE   = 12;
+const int TICKS_PER_PPU_DOT     = 4;
+const int PPU_DOTS_PER_SCANLINE = 341;
+const int TICKS_PER_SCANLINE    = TICKS_PER_PPU_DOT * PPU_DOTS_PER_SCANLINE;
+const int SCANLINES_PER_FRAME   = 262;
+const Ticks TICKS_PER_FRAME     = (Ticks) TICKS_PER_SCANLINE * SCANLINES_PER_FRAME;
+
+// Scanline counters on the cartridge are clocked at this dot of lines
+// 0 - 239 and the pre-render line, 241 times a frame
+const int SCANLINE_CLOCK_DOT    = 260;
+const int SCANLINE_CLOCKS       = 241;
+
+// Event types
+enum {
+    EVENT_SPRITE_0,         // end of a scanline sprite 0 may hit on
+    EVENT_VBLANK_START,     // scanline 241, dot 1
+    EVENT_NMI_POLL,         // NMI may have been enabled during VBlank
+    EVENT_VBLANK_END,       // scanline 261, dot 1
+    EVENT_MAPPER_IRQ,       // the mapper's scanline counter may raise an IRQ
+    EVENT_FRAME_END
+};
+
+class Scheduler {
+public:
+    struct Event {
+        Ticks time;
+        int type;
+        
+        // Depends on the type, e.g. the scanline
+        int data;
+    };
+    
+private:
+    std::vector<Event> heap;
+    
+public:
+    void schedule(Ticks time, int type, int data = 0);
+    
+    // Remove every event of a type
+    void cancel(int type);
+    
+    void clear() { heap.clear(); }
+    
+    bool empty() const { return heap.empty(); }
+    
+    // Earliest event. Only valid if not empty.
+    const Event& next() const { return heap.front(); }
+    
+    // Remove and return the earliest event
+    Event pop();
+};
+
+#endif // SCHEDULER_H
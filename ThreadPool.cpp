@@ -0,0 +1,101 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int num_threads) :
+    queued(0),
+    pending(0),
+    stopping(false),
+    next_queue(0) {
+    
+    if(num_threads <= 0) num_threads = std::thread::hardware_concurrency();
+    if(num_threads <= 0) num_threads = 1;
+    
+    for(int i = 0; i < num_threads; i++)
+        queues.push_back(new Queue);
+    
+    for(int i = 0; i < num_threads; i++)
+        threads.push_back(std::thread(&ThreadPool::work, this, i));
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    work_available.notify_all();
+    
+    for(unsigned int i = 0; i < threads.size(); i++)
+        threads[i].join();
+    
+    for(unsigned int i = 0; i < queues.size(); i++)
+        delete queues[i];
+}
+
+void ThreadPool::submit(const Job &job) {
+    Queue &queue = *queues[next_queue++ % queues.size()];
+    
+    {
+        std::lock_guard<std::mutex> guard(queue.lock);
+        queue.jobs.push_back(job);
+    }
+    
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        queued++;
+        pending++;
+    }
+    work_available.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> guard(lock);
+    while(pending > 0) all_done.wait(guard);
+}
+
+// Newest job from our own queue, else the oldest from someone else's
+bool ThreadPool::take(int worker, Job &job) {
+    int count = queues.size();
+    
+    for(int i = 0; i < count; i++) {
+        Queue &queue = *queues[(worker + i) % count];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        
+        if(queue.jobs.empty()) continue;
+        
+        if(i == 0) {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+        }
+        else {
+            job = queue.jobs.front();
+            queue.jobs.pop_front();
+        }
+        return true;
+    }
+    
+    return false;
+}
+
+void ThreadPool::work(int worker) {
+    Job job;
+    
+    while(true) {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            while(queued == 0 && !stopping) work_available.wait(guard);
+            
+            if(queued == 0) return;
+            
+            // Claim one of the queued jobs, then go and find it
+            queued--;
+        }
+        
+        // Another worker may be halfway through submitting it
+        while(!take(worker, job)) std::this_thread::yield();
+        
+        job();
+        job = Job();
+        
+        std::lock_guard<std::mutex> guard(lock);
+        if(--pending == 0) all_done.notify_all();
+    }
+}
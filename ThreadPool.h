@@ -0,0 +1,60 @@
+// Work-stealing thread pool
+//
+// Each worker has its own queue of jobs. Jobs are handed out round robin,
+// workers take from the back of their own queue and, when that runs dry,
+// steal from the front of the others'. Jobs are expected to be coarse
+// (a whole emulator run, or a frame of one), so the queues are simply
+// locked rather than lock-free.
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    typedef std::function<void()> Job;
+    
+private:
+    struct Queue {
+        std::deque<Job> jobs;
+        std::mutex lock;
+    };
+    
+    std::vector<Queue*> queues;
+    std::vector<std::thread> threads;
+    
+    // Guards the counts below
+    std::mutex lock;
+    std::condition_variable work_available;
+    std::condition_variable all_done;
+    
+    int queued;     // submitted, not yet taken by a worker
+    int pending;    // submitted, not yet finished
+    bool stopping;
+    
+    unsigned int next_queue;
+    
+    bool take(int worker, Job &job);
+    
+    void work(int worker);
+    
+public:
+    // 0 threads means one per hardware thread
+    ThreadPool(int num_threads);
+    ~ThreadPool();
+    
+    void submit(const Job &job);
+    
+    // Block until every submitted job has finished
+    void wait();
+    
+    int size() const { return threads.size(); }
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,9 @@
+#include "UxROM.h"
+
+UxROM::UxROM(const ROM &rom, Memory &mem, PPU &ppu, Controller &controller_1)
+    : Mapper(rom, mem, ppu, controller_1) {
+}
+
+void UxROM::write_register(Byte data, Word address) {
+    map_PRG_16K(0, data);
+}
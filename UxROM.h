@@ -0,0 +1,19 @@
+// UxROM (mapper 2)
+//
+// Any write to $8000-$FFFF selects the 16KB PRG bank at $8000. The last
+// bank stays at $C000. CHR is 8KB, usually RAM, and isn't switched.
+
+#ifndef UXROM_H
+#define UXROM_H
+
+#include "Constants.h"
+#include "Mapper.h"
+
+class UxROM : public Mapper {
+    void write_register(Byte data, Word address);
+    
+public:
+    UxROM(const ROM &rom, Memory &mem, PPU &ppu, Controller &controller_1);
+};
+
+#endif // UXROM_H
@@ -0,0 +1,44 @@
+#include "VecNES.h"
+
+VecNES::VecNES(const char* rom_file, int count, int threads, bool recompile) :
+    pool(threads) {
+    
+    try {
+        for(int i = 0; i < count; i++)
+            instances.push_back(new NES(rom_file, 0, 0, recompile));
+    }
+    catch(...) {
+        for(unsigned int i = 0; i < instances.size(); i++)
+            delete instances[i];
+        throw;
+    }
+    
+    frames_memory = new Byte[count * FRAME_SIZE + 63];
+    frames = (Byte*) (((size_t) frames_memory + 63) & ~(size_t) 63);
+    memset(frames, 0, count * FRAME_SIZE);
+}
+
+VecNES::~VecNES() {
+    for(unsigned int i = 0; i < instances.size(); i++)
+        delete instances[i];
+    
+    delete[] frames_memory;
+}
+
+void VecNES::step_instance(int i, Byte buttons) {
+    NES &nes = *instances[i];
+    
+    nes.set_buttons(buttons);
+    nes.step_frame();
+    
+    memcpy(frames + i * FRAME_SIZE, nes.get_framebuffer(), FRAME_SIZE);
+}
+
+const Byte* VecNES::step(const Byte* buttons) {
+    for(int i = 0; i < size(); i++)
+        pool.submit(std::bind(&VecNES::step_instance, this, i, buttons[i]));
+    
+    pool.wait();
+    
+    return frames;
+}
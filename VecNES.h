@@ -0,0 +1,54 @@
+// A batch of emulators stepped in lockstep, for training agents on games
+//
+// Every instance runs the same ROM. Each call to step() takes one button
+// byte per instance, runs one frame on all of them in parallel, and
+// leaves their framebuffers one after another in a single buffer, each
+// starting on a cache line.
+
+#ifndef VEC_NES_H
+#define VEC_NES_H
+
+#include "Constants.h"
+#include "NES.h"
+#include "ThreadPool.h"
+#include <vector>
+
+// Bytes of palette indices in one instance's frame
+const int FRAME_SIZE = 240 * 256;
+
+class VecNES {
+    std::vector<NES*> instances;
+    
+    ThreadPool pool;
+    
+    // FRAME_SIZE bytes per instance, 64-byte aligned within frames_memory
+    Byte* frames_memory;
+    Byte* frames;
+    
+    void step_instance(int i, Byte buttons);
+    
+public:
+    // Throws a message if the ROM can't be loaded. 0 threads means one
+    // per core.
+    VecNES(const char* rom_file, int count, int threads, bool recompile);
+    ~VecNES();
+    
+    int size() const { return instances.size(); }
+    
+    // Run one frame on every instance, holding buttons[i] (a bit each,
+    // BUTTON_A in bit 0) on controller 1 of instance i. Returns the frames.
+    const Byte* step(const Byte* buttons);
+    
+    // Frame of instance i is at get_frames() + i * FRAME_SIZE
+    const Byte* get_frames() const { return frames; }
+    
+    // Reset one instance, e.g. at the end of an episode
+    void reset(int i) { instances[i]->reset(); }
+    
+    // An instance that halted on an invalid opcode just repeats its frame
+    bool is_halted(int i) const { return instances[i]->is_halted(); }
+    
+    NES& get_instance(int i) { return *instances[i]; }
+};
+
+#endif // VEC_NES_H
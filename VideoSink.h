@@ -0,0 +1,20 @@
+// Where finished frames go. Display shows them in an SDL window; headless
+// runs have nowhere to show them and pass no sink at all.
+
+#ifndef VIDEO_SINK_H
+#define VIDEO_SINK_H
+
+#include "Constants.h"
+
+class VideoSink {
+public:
+    virtual ~VideoSink() {}
+    
+    // 240 scanlines of 256 palette indices
+    virtual void show(const Byte (*framebuffer)[256]) = 0;
+    
+    // Or of 256 colours, when the NES has colour output on
+    virtual void show(const Colour (*framebuffer)[256]) = 0;
+};
+
+#endif // VIDEO_SINK_H